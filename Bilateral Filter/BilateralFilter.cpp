@@ -8,18 +8,207 @@
 
 #include "BilateralFilter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
-#include <math.h>
-#include <opencv2/imgproc/imgproc.hpp>
+#include <vector>
+
+#include "imgs/ipcv/spatial_filtering/RowRing.h"
+#include "imgs/ipcv/utils/Parallel.h"
 
 using namespace std;
 
 namespace ipcv {
 
+// Output tile size [pixels]; a tile and the source rows it reads stay
+// resident in the per-core cache
+static const int kTileRows = 64;
+static const int kTileCols = 256;
+
+/** Spatial weights of a (2 radius + 1)^2 window, row major
+ *
+ *  \param[in] radius          radius of the window
+ *  \param[in] sigma_distance  standard deviation of distance/closeness filter
+ */
+static vector<float> SpatialWeights(const int radius,
+                                    const double sigma_distance) {
+  int diameter = 2 * radius + 1;
+  vector<float> spatial(diameter * diameter);
+  for (int i = -radius; i <= radius; i++) {
+    for (int j = -radius; j <= radius; j++) {
+      spatial[(i + radius) * diameter + j + radius] =
+          exp(-(i * i + j * j) / (2 * sigma_distance * sigma_distance));
+    }
+  }
+  return spatial;
+}
+
+/** Range weights indexed by the absolute difference of two samples
+ *
+ *  \param[in] levels       number of sample values (256 for 8-bit samples,
+ *                          65536 for 16-bit samples)
+ *  \param[in] sigma_range  standard deviation of range/similarity filter
+ */
+static vector<float> RangeWeights(const int levels, const double sigma_range) {
+  vector<float> range(levels);
+  for (int d = 0; d < levels; d++) {
+    range[d] = exp(-(static_cast<double>(d) * d) /
+                   (2 * sigma_range * sigma_range));
+  }
+  return range;
+}
+
+/** Runs body over the tiles covering an image, distributed over a pool of
+ *  worker threads
+ *
+ *  Every tile is computed independently and identically, so the result
+ *  does not depend on the number of threads.
+ */
+template <typename Body>
+static void ForEachTile(const cv::Size size, const int num_threads,
+                        Body body) {
+  int tiles_x = (size.width + kTileCols - 1) / kTileCols;
+  int tiles_y = (size.height + kTileRows - 1) / kTileRows;
+  ParallelFor(tiles_x * tiles_y, num_threads, [&](int begin, int end) {
+    for (int idx = begin; idx < end; idx++) {
+      int x = (idx % tiles_x) * kTileCols;
+      int y = (idx / tiles_x) * kTileRows;
+      body(cv::Rect(x, y, min(kTileCols, size.width - x),
+                    min(kTileRows, size.height - y)));
+    }
+  });
+}
+
+/** Bilateral filters one tile of an image
+ *
+ *  Each destination row is accumulated one window tap at a time over the
+ *  whole row, so the inner loop walks contiguous memory and the weights of
+ *  a tap are looked up rather than computed.
+ *
+ *  \param[in] spatial  (2 radius + 1)^2 spatial weights, row major
+ *  \param[in] range    range weights indexed by the absolute difference of
+ *                      two samples
+ *  \param[in] tile     region of dst to compute
+ */
+static void FilterTile(const cv::Mat &src, cv::Mat &dst, const int radius,
+                       const vector<float> &spatial, const float *range,
+                       const BorderMode border_mode,
+                       const uint8_t border_value, const cv::Rect &tile) {
+  int diameter = 2 * radius + 1;
+  int cn = src.channels();
+  int n = cn * tile.width;
+
+  RowRing ring(src, tile.x - radius, tile.width + 2 * radius, diameter,
+               border_mode, border_value);
+  vector<float> filtered(n);
+  vector<float> total(n);
+  for (int r = tile.y; r < tile.y + tile.height; r++) {
+    fill(filtered.begin(), filtered.end(), 0.0f);
+    fill(total.begin(), total.end(), 0.0f);
+    const uint8_t *center = src.ptr<uint8_t>(r) + cn * tile.x;
+    for (int i = 0; i < diameter; i++) {
+      const uint8_t *row = ring.Row(r - radius + i);
+      const float *spatial_ptr = &spatial[i * diameter];
+      for (int j = 0; j < diameter; j++) {
+        const uint8_t *s = row + cn * j;
+        float w_spatial = spatial_ptr[j];
+        for (int x = 0; x < n; x++) {
+          float bilateral = w_spatial * range[abs(s[x] - center[x])];
+          filtered[x] += bilateral * s[x];
+          total[x] += bilateral;
+        }
+      }
+    }
+
+    // The center tap always has weight 1 * 1, so total is never 0
+    uint8_t *dst_ptr = dst.ptr<uint8_t>(r) + cn * tile.x;
+    for (int x = 0; x < n; x++) {
+      dst_ptr[x] = cv::saturate_cast<uint8_t>(filtered[x] / total[x]);
+    }
+  }
+}
+
+/** Joint bilateral filters one tile of an image, with T source samples and
+ *  G guide samples
+ *
+ *  The range weight of a tap is the product of the range weights of the
+ *  guide channels, that is a Gaussian of the Euclidean guide distance.
+ *
+ *  \param[in] spatial  (2 radius + 1)^2 spatial weights, row major
+ *  \param[in] range    range weights indexed by the absolute difference of
+ *                      two guide samples
+ *  \param[in] tile     region of dst to compute
+ */
+template <typename T, typename G>
+static void FilterJointTile(const cv::Mat &src, const cv::Mat &guide,
+                            cv::Mat &dst, const int radius,
+                            const vector<float> &spatial, const float *range,
+                            const BorderMode border_mode,
+                            const uint8_t border_value, const cv::Rect &tile) {
+  int diameter = 2 * radius + 1;
+  int cn = src.channels();
+  int gn = guide.channels();
+  int width = tile.width;
+
+  RowRing src_ring(src, tile.x - radius, width + 2 * radius, diameter,
+                   border_mode, border_value);
+  RowRing guide_ring(guide, tile.x - radius, width + 2 * radius, diameter,
+                     border_mode, border_value);
+  vector<float> weights(width);
+  vector<float> filtered(cn * width);
+  vector<float> total(width);
+  for (int r = tile.y; r < tile.y + tile.height; r++) {
+    fill(filtered.begin(), filtered.end(), 0.0f);
+    fill(total.begin(), total.end(), 0.0f);
+    const G *center = guide.ptr<G>(r) + gn * tile.x;
+    for (int i = 0; i < diameter; i++) {
+      const T *src_row = reinterpret_cast<const T *>(
+          src_ring.Row(r - radius + i));
+      const G *guide_row = reinterpret_cast<const G *>(
+          guide_ring.Row(r - radius + i));
+      const float *spatial_ptr = &spatial[i * diameter];
+      for (int j = 0; j < diameter; j++) {
+        // Weights of the tap for the whole row first, then the samples
+        const G *g = guide_row + gn * j;
+        for (int x = 0; x < width; x++) {
+          float bilateral = spatial_ptr[j];
+          for (int k = 0; k < gn; k++) {
+            bilateral *= range[abs(g[gn * x + k] - center[gn * x + k])];
+          }
+          weights[x] = bilateral;
+          total[x] += bilateral;
+        }
+        const T *s = src_row + cn * j;
+        for (int x = 0; x < width; x++) {
+          for (int k = 0; k < cn; k++) {
+            filtered[cn * x + k] += weights[x] * s[cn * x + k];
+          }
+        }
+      }
+    }
+
+    // The center tap always has weight 1 * 1, so total is never 0
+    T *dst_ptr = dst.ptr<T>(r) + cn * tile.x;
+    for (int x = 0; x < width; x++) {
+      for (int k = 0; k < cn; k++) {
+        dst_ptr[cn * x + k] =
+            cv::saturate_cast<T>(filtered[cn * x + k] / total[x]);
+      }
+    }
+  }
+}
+
 /** Bilateral filter an image
  *
- *  \param[in] src             source cv::Mat of CV_8UC3
- *  \param[out] dst            destination cv::Mat of ddepth type
+ *  Every channel is filtered with the range filter on its own values, over
+ *  a symmetric (2 radius + 1)^2 window.  Pixels outside of the image are
+ *  extrapolated with the border mode, so every pixel is filtered and dst
+ *  has the size of src.
+ *
+ *  \param[in] src             source cv::Mat of CV_8U with any number of
+ *                             channels
+ *  \param[out] dst            destination cv::Mat of the src type
  *  \param[in] sigma_distance  standard deviation of distance/closeness filter
  *  \param[in] sigma_range     standard deviation of range/similarity filter
  *  \param[in] radius          radius of the bilateral filter (if negative, use
@@ -27,130 +216,117 @@ namespace ipcv {
  *                             closeness filter)
  *  \param[in] border_mode     pixel extrapolation method
  *  \param[in] border_value    value to use for constant border mode
+ *  \param[in] num_threads     number of worker threads the tiles are
+ *                             distributed over (if less than 1, use the
+ *                             number of hardware threads)
  */
 bool BilateralFilter(const cv::Mat &src, cv::Mat &dst,
                      const double sigma_distance, const double sigma_range,
                      const int radius, const BorderMode border_mode,
-                     uint8_t border_value) {
-  dst.create(src.size(), src.type());
-
-  cv::Mat src_lab = src.clone();
-  cv::Mat src_gray = src.clone();
-  cv::Mat src_lab_range = src.clone();
-  cv::Mat dst_lab;
-  dst_lab.create(src.size(), src.type());
-
-  /*Grayscale images take around 1 min
-   *Color images take around 4-5 mins
-   *It works pls be patient qwq
-   */
-
-  // for each color channel
-  for (int chan = 0; chan < 3; chan++) {
-    // for source rows and cols
-    for (int rows = 2; rows < src.rows - 2; rows++) {
-      for (int cols = 2; cols < src.cols - 2; cols++) {
-        // check if the image is grayscale
-        if (src_gray.at<cv::Vec3b>(rows, cols)[0] ==
-            src_gray.at<cv::Vec3b>(rows, cols)[1]) {
-
-          double filtered = 0;
-          double FilterMax = 0;
-          int neighbor_x = 0;
-          int neighbor_y = 0;
-          float y = 0;
-          int size = 0;
-          // if radius is negative, it is twice the distance standard deviation
-          if (radius < 0) {
-            size = sigma_distance * 2;
-            // else, the radius is the filter size
-          } else {
-            size = radius;
-          }
-          // For the AOI
-          for (int i = 0; i < size * 2; i++) {
-            for (int j = 0; j < size * 2; j++) {
-              neighbor_x = rows - (size - i);
-              neighbor_y = cols - (size - j);
-              // compute range filter
-              float x = src_gray.at<cv::Vec3b>(neighbor_x, neighbor_y)[0] -
-                        src_gray.at<cv::Vec3b>(rows, cols)[0];
-              double range = exp(-(pow(x, 2)) / (2 * pow(sigma_range, 2)));
-              // compute spatial filter
-              y = float(
-                  sqrt(pow(rows - neighbor_x, 2) + pow(cols - neighbor_y, 2)));
-              double spatial = exp(-(pow(y, 2)) / (2 * pow(sigma_distance, 2)));
-              // multiply range and spatial to get bilateral filter
-              double bilateral = range * spatial;
-              filtered =
-                  filtered +
-                  src_gray.at<cv::Vec3b>(neighbor_x, neighbor_y)[0] * bilateral;
-              FilterMax = FilterMax + bilateral;
-            }
-          }
-          // normalize and apply filter
-          filtered = filtered / FilterMax;
-          dst.at<cv::Vec3b>(rows, cols)[0] = filtered;
-          dst.at<cv::Vec3b>(rows, cols)[1] = filtered;
-          dst.at<cv::Vec3b>(rows, cols)[2] = filtered;
+                     uint8_t border_value, const int num_threads) {
+  if (src.depth() != CV_8U) {
+    cerr << "*** ERROR *** ";
+    cerr << "BilateralFilter supports CV_8U sources" << endl;
+    return false;
+  }
 
-        }
+  // Read from a copy when filtering in place, since tiles read source rows
+  // other tiles have already written
+  const cv::Mat source = src.data == dst.data ? src.clone() : src;
+  dst.create(source.size(), source.type());
 
-        // For color images, use CIE Lab space and only filter on the L channel
-        // for similarity filter
-        else {
-          double filtered = 0;
-          double FilterMax = 0;
-          int neighbor_x = 0;
-          int neighbor_y = 0;
-          float y = 0;
-          int size = 0;
-          // if the radius is negative, the value is twice the distance standard
-          // deviation
-          if (radius < 0) {
-            size = sigma_distance * 2;
-            // else, the radius is the size of the filter
-          } else {
-            size = radius;
-          }
-          // For range filter (similarity) convert to Lab space
-          cv::cvtColor(src_lab, src_lab_range, cv::COLOR_BGR2Lab);
-          // in the AOI
-          for (int i = 0; i < size * 2; i++) {
-            for (int j = 0; j < size * 2; j++) {
-              neighbor_x = rows - (size - i);
-              neighbor_y = cols - (size - j);
-              // compute range filter in lab space
-              float x = src_lab.at<cv::Vec3b>(neighbor_x, neighbor_y)[chan] -
-                        src_lab.at<cv::Vec3b>(rows, cols)[chan];
-              double range = exp(-(pow(x, 2)) / (2 * pow(sigma_range, 2)));
-              // compute spatial filter in DC space
-              y = float(
-                  sqrt(pow(rows - neighbor_x, 2) + pow(cols - neighbor_y, 2)));
-              double spatial = exp(-(pow(y, 2)) / (2 * pow(sigma_distance, 2)));
-              // multiply the filters to get bilateral filter
-              double bilateral = range * spatial;
-              filtered = filtered +
-                         src_lab.at<cv::Vec3b>(neighbor_x, neighbor_y)[chan] *
-                             bilateral;
-
-              FilterMax = FilterMax + bilateral;
-            }
-          }
-          // normalize and apply the filter
-          filtered = filtered / FilterMax;
-          dst.at<cv::Vec3b>(rows, cols)[chan] = filtered;
-        }
+  // if radius is negative, it is twice the distance standard deviation
+  int size = radius < 0 ? static_cast<int>(sigma_distance * 2) : radius;
+
+  // Spatial weights depend only on the offset within the window and range
+  // weights only on the absolute difference of two 8-bit values, so both
+  // are tabulated once per image
+  vector<float> spatial = SpatialWeights(size, sigma_distance);
+  vector<float> range = RangeWeights(256, sigma_range);
+
+  ForEachTile(source.size(), num_threads, [&](const cv::Rect &tile) {
+    FilterTile(source, dst, size, spatial, range.data(), border_mode,
+               border_value, tile);
+  });
+
+  return true;
+}
+
+/** Joint (cross) bilateral filter an image, taking the range weights from a
+ *  guide image
+ *
+ *  \param[in] src             source cv::Mat of CV_8U, CV_16U, CV_16S or
+ *                             CV_32F with any number of channels
+ *  \param[in] guide           guide cv::Mat of CV_8U or CV_16U with any number
+ *                             of channels, of the src size
+ *  \param[out] dst            destination cv::Mat of the src type
+ *  \param[in] sigma_distance  standard deviation of distance/closeness filter
+ *  \param[in] sigma_range     standard deviation of range/similarity filter,
+ *                             in guide digital counts
+ *  \param[in] radius          radius of the bilateral filter (if negative, use
+ *                             twice the standard deviation of the distance/
+ *                             closeness filter)
+ *  \param[in] border_mode     pixel extrapolation method
+ *  \param[in] border_value    value to use for constant border mode
+ *  \param[in] num_threads     number of worker threads the tiles are
+ *                             distributed over (if less than 1, use the
+ *                             number of hardware threads)
+ */
+bool JointBilateralFilter(const cv::Mat &src, const cv::Mat &guide,
+                          cv::Mat &dst, const double sigma_distance,
+                          const double sigma_range, const int radius,
+                          const BorderMode border_mode, uint8_t border_value,
+                          const int num_threads) {
+  int depth = src.depth();
+  if ((depth != CV_8U && depth != CV_16U && depth != CV_16S &&
+       depth != CV_32F) ||
+      (guide.depth() != CV_8U && guide.depth() != CV_16U) ||
+      guide.size() != src.size()) {
+    cerr << "*** ERROR *** ";
+    cerr << "JointBilateralFilter supports CV_8U, CV_16U, CV_16S and CV_32F "
+            "sources with a CV_8U or CV_16U guide of the same size"
+         << endl;
+    return false;
+  }
+
+  // Read from copies when filtering in place
+  const cv::Mat source = src.data == dst.data ? src.clone() : src;
+  const cv::Mat guidance = guide.data == dst.data ? guide.clone() : guide;
+  dst.create(source.size(), source.type());
+
+  int size = radius < 0 ? static_cast<int>(sigma_distance * 2) : radius;
+  vector<float> spatial = SpatialWeights(size, sigma_distance);
+  vector<float> range =
+      RangeWeights(guidance.depth() == CV_8U ? 256 : 65536, sigma_range);
+
+  ForEachTile(source.size(), num_threads, [&](const cv::Rect &tile) {
+    auto filter = [&](auto src_sample, auto guide_sample) {
+      FilterJointTile<decltype(src_sample), decltype(guide_sample)>(
+          source, guidance, dst, size, spatial, range.data(), border_mode,
+          border_value, tile);
+    };
+    auto with_guide = [&](auto src_sample) {
+      if (guidance.depth() == CV_8U) {
+        filter(src_sample, uint8_t());
+      } else {
+        filter(src_sample, uint16_t());
       }
+    };
+    switch (depth) {
+    case CV_8U:
+      with_guide(uint8_t());
+      break;
+    case CV_16U:
+      with_guide(uint16_t());
+      break;
+    case CV_16S:
+      with_guide(int16_t());
+      break;
+    default:
+      with_guide(float());
     }
+  });
 
-    // border mode replicate
-    if (border_mode == ipcv::BorderMode::REPLICATE) {
-      int border = 2;
-      cv::copyMakeBorder(dst, dst, border, border, border, border,
-                         cv::BORDER_REPLICATE);
-    }
+  return true;
 }
-    return true;
-  }
 } // namespace ipcv
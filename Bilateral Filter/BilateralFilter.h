@@ -0,0 +1,158 @@
+/** Interface file for bilateral filtering
+ *
+ *  \file ipcv/bilateral_filtering/BilateralFilter.h
+ *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
+ *  \date 27 Oct 2020
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include "imgs/ipcv/utils/BorderMode.h"
+
+namespace ipcv {
+
+/** Bilateral filter an image
+ *
+ *  Every channel is filtered with the range filter on its own values, over
+ *  a symmetric (2 radius + 1)^2 window.  Pixels outside of the image are
+ *  extrapolated with the border mode, so every pixel is filtered and dst
+ *  has the size of src.
+ *
+ *  \param[in] src             source cv::Mat of CV_8U with any number of
+ *                             channels
+ *  \param[out] dst            destination cv::Mat of the src type
+ *  \param[in] sigma_distance  standard deviation of distance/closeness filter
+ *  \param[in] sigma_range     standard deviation of range/similarity filter
+ *  \param[in] radius          radius of the bilateral filter (if negative, use
+ *                             twice the standard deviation of the distance/
+ *                             closeness filter)
+ *  \param[in] border_mode     pixel extrapolation method
+ *  \param[in] border_value    value to use for constant border mode
+ *  \param[in] num_threads     number of worker threads the tiles are
+ *                             distributed over (if less than 1, use the
+ *                             number of hardware threads); the result does
+ *                             not depend on the thread count
+ */
+bool BilateralFilter(const cv::Mat& src, cv::Mat& dst,
+                     const double sigma_distance, const double sigma_range,
+                     const int radius = -1,
+                     const BorderMode border_mode = BorderMode::CONSTANT,
+                     uint8_t border_value = 0, const int num_threads = 0);
+
+/** Joint (cross) bilateral filter an image, taking the range weights from a
+ *  guide image
+ *
+ *  The samples of src (a depth map, a flow field, ...) are averaged with
+ *  weights that fall off with the distance between guide pixels (an RGB
+ *  frame, ...), so src is smoothed without crossing the edges of the guide.
+ *  The range weight of a multi-channel guide is a Gaussian of the
+ *  Euclidean distance between guide pixels.
+ *
+ *  \param[in] src             source cv::Mat of CV_8U, CV_16U, CV_16S or
+ *                             CV_32F with any number of channels
+ *  \param[in] guide           guide cv::Mat of CV_8U or CV_16U with any number
+ *                             of channels, of the src size
+ *  \param[out] dst            destination cv::Mat of the src type
+ *  \param[in] sigma_distance  standard deviation of distance/closeness filter
+ *  \param[in] sigma_range     standard deviation of range/similarity filter,
+ *                             in guide digital counts
+ *  \param[in] radius          radius of the bilateral filter (if negative, use
+ *                             twice the standard deviation of the distance/
+ *                             closeness filter)
+ *  \param[in] border_mode     pixel extrapolation method
+ *  \param[in] border_value    value to use for constant border mode
+ *  \param[in] num_threads     number of worker threads the tiles are
+ *                             distributed over (if less than 1, use the
+ *                             number of hardware threads)
+ */
+bool JointBilateralFilter(const cv::Mat& src, const cv::Mat& guide,
+                          cv::Mat& dst, const double sigma_distance,
+                          const double sigma_range, const int radius = -1,
+                          const BorderMode border_mode = BorderMode::CONSTANT,
+                          uint8_t border_value = 0, const int num_threads = 0);
+
+/** Guided filter an image
+ *
+ *  An edge preserving alternative to BilateralFilter: each output pixel is
+ *  a linear function of the guide, fitted to src over the (2 radius + 1)^2
+ *  windows containing it.  Window means come from integral images, so the
+ *  cost per pixel is independent of the radius.  Each channel of src is
+ *  guided by the matching channel of a multi-channel guide.
+ *
+ *  \param[in] src          source cv::Mat with any depth and number of
+ *                          channels
+ *  \param[in] guide        guide cv::Mat of the src size with one channel or
+ *                          the channels of src (src itself for edge
+ *                          preserving smoothing)
+ *  \param[out] dst         destination cv::Mat of the src type
+ *  \param[in] radius       radius of the box windows
+ *  \param[in] epsilon      regularization of the local linear model, in
+ *                          squared guide digital counts; edges with a
+ *                          variance well above epsilon are preserved (see
+ *                          GuidedFilterEpsilon)
+ *  \param[in] num_threads  number of worker threads the channels are
+ *                          distributed over (if less than 1, use the number
+ *                          of hardware threads)
+ */
+bool GuidedFilter(const cv::Mat& src, const cv::Mat& guide, cv::Mat& dst,
+                  const int radius, const double epsilon,
+                  const int num_threads = 0);
+
+/** Guided filter regularization comparable to a bilateral range filter
+ *
+ *  The guided filter keeps edges whose local variance is well above
+ *  epsilon, as the bilateral filter keeps edges well above sigma_range, so
+ *  sigma_range^2 gives a GuidedFilter result of similar edge strength.
+ *
+ *  \param[in] sigma_range  standard deviation of range/similarity filter
+ *
+ *  \return                 epsilon for GuidedFilter, in squared digital
+ *                          counts
+ */
+double GuidedFilterEpsilon(const double sigma_range);
+
+/** Approximate bilateral filter of an image on a bilateral grid
+ *
+ *  Each channel is splatted into a coarse (x, y, value) grid whose cells are
+ *  sigma_distance / accuracy pixels by sigma_range / accuracy digital counts,
+ *  blurred there with a small Gaussian and sliced back out.  The cost is
+ *  independent of sigma_distance (larger sigmas only make the grid smaller).
+ *
+ *  \param[in] src             source cv::Mat of CV_8U with any number of
+ *                             channels
+ *  \param[out] dst            destination cv::Mat of the src type
+ *  \param[in] sigma_distance  standard deviation of distance/closeness filter
+ *  \param[in] sigma_range     standard deviation of range/similarity filter
+ *  \param[in] accuracy        number of grid cells per standard deviation
+ *                             (1 is the usual trade-off; larger values are
+ *                             closer to the exact filter and slower)
+ *  \param[in] num_threads     number of worker threads (if less than 1, use
+ *                             the number of hardware threads)
+ */
+bool BilateralGrid(const cv::Mat& src, cv::Mat& dst,
+                   const double sigma_distance, const double sigma_range,
+                   const double accuracy = 1.0, const int num_threads = 0);
+
+/** Reports how close the bilateral grid approximation is to the exact filter
+ *
+ *  \param[in] src             source cv::Mat of CV_8U
+ *  \param[in] sigma_distance  standard deviation of distance/closeness filter
+ *  \param[in] sigma_range     standard deviation of range/similarity filter
+ *  \param[in] accuracy        number of grid cells per standard deviation
+ *  \param[in] radius          radius of the exact filter (if negative, use
+ *                             twice the standard deviation of the distance/
+ *                             closeness filter)
+ *  \param[in] border_mode     pixel extrapolation method of the exact filter
+ *  \param[in] border_value    value to use for constant border mode
+ *
+ *  \return                    PSNR [dB] of the BilateralGrid result against
+ *                             the BilateralFilter result
+ */
+double BilateralGridPSNR(const cv::Mat& src, const double sigma_distance,
+                         const double sigma_range, const double accuracy = 1.0,
+                         const int radius = -1,
+                         const BorderMode border_mode = BorderMode::CONSTANT,
+                         uint8_t border_value = 0);
+}
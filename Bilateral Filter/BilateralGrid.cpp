@@ -0,0 +1,242 @@
+/** Implementation file for approximate bilateral filtering on a bilateral
+ *  grid
+ *
+ *  \file ipcv/bilateral_filtering/BilateralGrid.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "BilateralFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "imgs/ipcv/utils/Parallel.h"
+
+using namespace std;
+
+namespace ipcv {
+
+/** Normalized Gaussian weights over [-radius, radius], radius = ceil(2 sigma)
+ *
+ *  \param[in] sigma  standard deviation [grid cells]
+ *
+ *  \return           2 * radius + 1 weights
+ */
+static vector<float> GaussianTaps(const double sigma) {
+  int radius = static_cast<int>(ceil(2 * sigma));
+  vector<float> taps(2 * radius + 1);
+  double sum = 0;
+  for (int k = -radius; k <= radius; k++) {
+    taps[k + radius] = exp(-(k * k) / (2 * sigma * sigma));
+    sum += taps[k + radius];
+  }
+  for (auto &tap : taps) {
+    tap /= sum;
+  }
+  return taps;
+}
+
+/** Blurs every line of (value, weight) cells along one axis of the grid
+ *
+ *  \param[in,out] grid  interleaved (value, weight) cells
+ *  \param[in] lines     number of lines along the axis
+ *  \param[in] length    number of cells in a line
+ *  \param[in] stride    offset between consecutive cells of a line [cells]
+ *  \param[in] taps      Gaussian weights
+ *  \param[in] line_of   maps a line index to the offset of its first cell
+ *                       [cells]
+ */
+template <typename LineOffset>
+static void BlurAxis(vector<float> &grid, const int lines, const int length,
+                     const int stride, const vector<float> &taps,
+                     LineOffset line_of) {
+  int radius = taps.size() / 2;
+  vector<float> line(2 * length);
+  for (int l = 0; l < lines; l++) {
+    float *cells = &grid[2 * line_of(l)];
+    for (int k = 0; k < length; k++) {
+      line[2 * k] = cells[2 * k * stride];
+      line[2 * k + 1] = cells[2 * k * stride + 1];
+    }
+
+    // The grid is padded by the blur radius, so cells past either end are
+    // empty and simply skipped
+    for (int k = 0; k < length; k++) {
+      float value = 0;
+      float weight = 0;
+      for (int t = max(-radius, -k); t <= min(radius, length - 1 - k); t++) {
+        value += taps[t + radius] * line[2 * (k + t)];
+        weight += taps[t + radius] * line[2 * (k + t) + 1];
+      }
+      cells[2 * k * stride] = value;
+      cells[2 * k * stride + 1] = weight;
+    }
+  }
+}
+
+/** Approximate bilateral filter of one channel
+ *
+ *  \param[in] src             source cv::Mat of CV_8U
+ *  \param[in] chan            channel to filter
+ *  \param[out] dst            destination cv::Mat of the src type
+ *  \param[in] cell_distance   grid cell size [pixels]
+ *  \param[in] cell_range      grid cell size [digital counts]
+ *  \param[in] sigma_distance  standard deviation of distance/closeness filter
+ *  \param[in] sigma_range     standard deviation of range/similarity filter
+ */
+static void FilterChannel(const cv::Mat &src, const int chan, cv::Mat &dst,
+                          const double cell_distance, const double cell_range,
+                          const double sigma_distance,
+                          const double sigma_range) {
+  int cn = src.channels();
+
+  // Blur in grid units; the grid is padded by the blur radius so that no
+  // splatted sample leaks past its edges
+  vector<float> taps_xy = GaussianTaps(sigma_distance / cell_distance);
+  vector<float> taps_z = GaussianTaps(sigma_range / cell_range);
+  int pad_xy = taps_xy.size() / 2 + 1;
+  int pad_z = taps_z.size() / 2 + 1;
+  int gw = static_cast<int>((src.cols - 1) / cell_distance) + 1 + 2 * pad_xy;
+  int gh = static_cast<int>((src.rows - 1) / cell_distance) + 1 + 2 * pad_xy;
+  int gd = static_cast<int>(255 / cell_range) + 1 + 2 * pad_z;
+
+  // Cells are (value, weight) pairs, value fastest
+  vector<float> grid(2 * static_cast<size_t>(gw) * gh * gd, 0.0f);
+  auto cell = [&](const int gx, const int gy, const int gz) {
+    return 2 * ((static_cast<size_t>(gy) * gw + gx) * gd + gz);
+  };
+
+  // Splat every pixel into its 8 surrounding cells
+  for (int r = 0; r < src.rows; r++) {
+    const uint8_t *src_ptr = src.ptr<uint8_t>(r);
+    float fy = r / cell_distance + pad_xy;
+    int y0 = static_cast<int>(fy);
+    float wy = fy - y0;
+    for (int c = 0; c < src.cols; c++) {
+      float value = src_ptr[cn * c + chan];
+      float fx = c / cell_distance + pad_xy;
+      float fz = value / cell_range + pad_z;
+      int x0 = static_cast<int>(fx);
+      int z0 = static_cast<int>(fz);
+      float wx = fx - x0;
+      float wz = fz - z0;
+      for (int k = 0; k < 8; k++) {
+        float w = ((k & 1) ? wx : 1 - wx) * ((k & 2) ? wy : 1 - wy) *
+                  ((k & 4) ? wz : 1 - wz);
+        size_t idx = cell(x0 + (k & 1), y0 + ((k >> 1) & 1), z0 + (k >> 2));
+        grid[idx] += w * value;
+        grid[idx + 1] += w;
+      }
+    }
+  }
+
+  // Separable Gaussian blur along the value, x and y axes
+  BlurAxis(grid, gw * gh, gd, 1, taps_z,
+           [&](const int l) { return static_cast<size_t>(l) * gd; });
+  BlurAxis(grid, gh * gd, gw, gd, taps_xy, [&](const int l) {
+    return (static_cast<size_t>(l / gd) * gw) * gd + l % gd;
+  });
+  BlurAxis(grid, gw * gd, gh, gw * gd, taps_xy,
+           [&](const int l) { return static_cast<size_t>(l); });
+
+  // Slice the grid at every pixel and normalize
+  for (int r = 0; r < src.rows; r++) {
+    const uint8_t *src_ptr = src.ptr<uint8_t>(r);
+    uint8_t *dst_ptr = dst.ptr<uint8_t>(r);
+    float fy = r / cell_distance + pad_xy;
+    int y0 = static_cast<int>(fy);
+    float wy = fy - y0;
+    for (int c = 0; c < src.cols; c++) {
+      float value = src_ptr[cn * c + chan];
+      float fx = c / cell_distance + pad_xy;
+      float fz = value / cell_range + pad_z;
+      int x0 = static_cast<int>(fx);
+      int z0 = static_cast<int>(fz);
+      float wx = fx - x0;
+      float wz = fz - z0;
+      float filtered = 0;
+      float total = 0;
+      for (int k = 0; k < 8; k++) {
+        float w = ((k & 1) ? wx : 1 - wx) * ((k & 2) ? wy : 1 - wy) *
+                  ((k & 4) ? wz : 1 - wz);
+        size_t idx = cell(x0 + (k & 1), y0 + ((k >> 1) & 1), z0 + (k >> 2));
+        filtered += w * grid[idx];
+        total += w * grid[idx + 1];
+      }
+      dst_ptr[cn * c + chan] =
+          total > 0 ? cv::saturate_cast<uint8_t>(filtered / total) : value;
+    }
+  }
+}
+
+/** Approximate bilateral filter of an image on a bilateral grid
+ *
+ *  \param[in] src             source cv::Mat of CV_8U with any number of
+ *                             channels
+ *  \param[out] dst            destination cv::Mat of the src type
+ *  \param[in] sigma_distance  standard deviation of distance/closeness filter
+ *  \param[in] sigma_range     standard deviation of range/similarity filter
+ *  \param[in] accuracy        number of grid cells per standard deviation
+ *  \param[in] num_threads     number of worker threads the channels are
+ *                             distributed over (if less than 1, use the
+ *                             number of hardware threads)
+ */
+bool BilateralGrid(const cv::Mat &src, cv::Mat &dst,
+                   const double sigma_distance, const double sigma_range,
+                   const double accuracy, const int num_threads) {
+  if (src.depth() != CV_8U || sigma_distance <= 0 || sigma_range <= 0 ||
+      accuracy <= 0) {
+    cerr << "*** ERROR *** ";
+    cerr << "BilateralGrid needs a CV_8U source and positive standard "
+            "deviations and accuracy"
+         << endl;
+    return false;
+  }
+  dst.create(src.size(), src.type());
+
+  // Cells are never finer than a pixel or a digital count; finer cells
+  // would only add empty work
+  double cell_distance = max(sigma_distance / accuracy, 1.0);
+  double cell_range = max(sigma_range / accuracy, 1.0);
+
+  ParallelFor(src.channels(), num_threads, [&](int begin, int end) {
+    for (int chan = begin; chan < end; chan++) {
+      FilterChannel(src, chan, dst, cell_distance, cell_range,
+                    sigma_distance, sigma_range);
+    }
+  });
+
+  return true;
+}
+
+/** Reports how close the bilateral grid approximation is to the exact filter
+ *
+ *  \param[in] src             source cv::Mat of CV_8U
+ *  \param[in] sigma_distance  standard deviation of distance/closeness filter
+ *  \param[in] sigma_range     standard deviation of range/similarity filter
+ *  \param[in] accuracy        number of grid cells per standard deviation
+ *  \param[in] radius          radius of the exact filter (if negative, use
+ *                             twice the standard deviation of the distance/
+ *                             closeness filter)
+ *  \param[in] border_mode     pixel extrapolation method of the exact filter
+ *  \param[in] border_value    value to use for constant border mode
+ *
+ *  \return                    PSNR [dB] of the BilateralGrid result against
+ *                             the BilateralFilter result
+ */
+double BilateralGridPSNR(const cv::Mat &src, const double sigma_distance,
+                         const double sigma_range, const double accuracy,
+                         const int radius, const BorderMode border_mode,
+                         uint8_t border_value) {
+  cv::Mat grid_dst;
+  cv::Mat exact_dst;
+  BilateralGrid(src, grid_dst, sigma_distance, sigma_range, accuracy);
+  BilateralFilter(src, exact_dst, sigma_distance, sigma_range, radius,
+                  border_mode, border_value);
+
+  return cv::PSNR(grid_dst, exact_dst);
+}
+} // namespace ipcv
@@ -0,0 +1,168 @@
+/** Implementation file for guided filtering
+ *
+ *  \file ipcv/bilateral_filtering/GuidedFilter.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "BilateralFilter.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <opencv2/imgproc.hpp>
+
+#include "imgs/ipcv/utils/Parallel.h"
+
+using namespace std;
+
+namespace ipcv {
+
+/** Mean of every (2 radius + 1)^2 window of a plane, from its integral
+ *  image in O(1) per pixel
+ *
+ *  Windows are clipped to the image and averaged over the pixels they
+ *  still cover, so no border extrapolation is needed.
+ *
+ *  \param[in] plane   single-channel CV_64F plane
+ *  \param[in] radius  radius of the window
+ *  \param[out] mean   CV_64F plane of window means
+ */
+static void BoxMean(const cv::Mat &plane, const int radius, cv::Mat &mean) {
+  cv::Mat sum;
+  cv::integral(plane, sum, CV_64F);
+  mean.create(plane.size(), CV_64FC1);
+  for (int r = 0; r < plane.rows; r++) {
+    int top = max(r - radius, 0);
+    int bottom = min(r + radius + 1, plane.rows);
+    const double *top_ptr = sum.ptr<double>(top);
+    const double *bottom_ptr = sum.ptr<double>(bottom);
+    double *mean_ptr = mean.ptr<double>(r);
+    for (int c = 0; c < plane.cols; c++) {
+      int left = max(c - radius, 0);
+      int right = min(c + radius + 1, plane.cols);
+      double total = bottom_ptr[right] - bottom_ptr[left] - top_ptr[right] +
+                     top_ptr[left];
+      mean_ptr[c] = total / ((bottom - top) * (right - left));
+    }
+  }
+}
+
+/** Guided filter of one channel
+ *
+ *  \param[in] p        CV_64F plane to filter
+ *  \param[in] I        CV_64F guide plane
+ *  \param[in] radius   radius of the box windows
+ *  \param[in] epsilon  regularization of the local linear model
+ *  \param[out] q       CV_64F filtered plane
+ */
+static void FilterChannel(const cv::Mat &p, const cv::Mat &I,
+                          const int radius, const double epsilon,
+                          cv::Mat &q) {
+  cv::Mat Ip = I.mul(p);
+  cv::Mat II = I.mul(I);
+  cv::Mat mean_I;
+  cv::Mat mean_p;
+  cv::Mat mean_Ip;
+  cv::Mat mean_II;
+  BoxMean(I, radius, mean_I);
+  BoxMean(p, radius, mean_p);
+  BoxMean(Ip, radius, mean_Ip);
+  BoxMean(II, radius, mean_II);
+
+  // Coefficients of the linear model q = a I + b fitted in every window
+  cv::Mat a(p.size(), CV_64FC1);
+  cv::Mat b(p.size(), CV_64FC1);
+  for (int r = 0; r < p.rows; r++) {
+    const double *m_I = mean_I.ptr<double>(r);
+    const double *m_p = mean_p.ptr<double>(r);
+    const double *m_Ip = mean_Ip.ptr<double>(r);
+    const double *m_II = mean_II.ptr<double>(r);
+    double *a_ptr = a.ptr<double>(r);
+    double *b_ptr = b.ptr<double>(r);
+    for (int c = 0; c < p.cols; c++) {
+      double cov_Ip = m_Ip[c] - m_I[c] * m_p[c];
+      double var_I = m_II[c] - m_I[c] * m_I[c];
+      a_ptr[c] = cov_Ip / (var_I + epsilon);
+      b_ptr[c] = m_p[c] - a_ptr[c] * m_I[c];
+    }
+  }
+
+  // Every pixel averages the models of the windows covering it
+  cv::Mat mean_a;
+  cv::Mat mean_b;
+  BoxMean(a, radius, mean_a);
+  BoxMean(b, radius, mean_b);
+  q.create(p.size(), CV_64FC1);
+  for (int r = 0; r < p.rows; r++) {
+    const double *I_ptr = I.ptr<double>(r);
+    const double *a_ptr = mean_a.ptr<double>(r);
+    const double *b_ptr = mean_b.ptr<double>(r);
+    double *q_ptr = q.ptr<double>(r);
+    for (int c = 0; c < p.cols; c++) {
+      q_ptr[c] = a_ptr[c] * I_ptr[c] + b_ptr[c];
+    }
+  }
+}
+
+/** Guided filter regularization comparable to a bilateral range filter
+ *
+ *  \param[in] sigma_range  standard deviation of range/similarity filter
+ *
+ *  \return                 epsilon for GuidedFilter, in squared digital
+ *                          counts
+ */
+double GuidedFilterEpsilon(const double sigma_range) {
+  return sigma_range * sigma_range;
+}
+
+/** Guided filter an image
+ *
+ *  \param[in] src          source cv::Mat with any depth and number of
+ *                          channels
+ *  \param[in] guide        guide cv::Mat of the src size with one channel or
+ *                          the channels of src (src itself for edge
+ *                          preserving smoothing)
+ *  \param[out] dst         destination cv::Mat of the src type
+ *  \param[in] radius       radius of the box windows
+ *  \param[in] epsilon      regularization of the local linear model, in
+ *                          squared guide digital counts
+ *  \param[in] num_threads  number of worker threads the channels are
+ *                          distributed over (if less than 1, use the number
+ *                          of hardware threads)
+ */
+bool GuidedFilter(const cv::Mat &src, const cv::Mat &guide, cv::Mat &dst,
+                  const int radius, const double epsilon,
+                  const int num_threads) {
+  if (guide.size() != src.size() ||
+      (guide.channels() != 1 && guide.channels() != src.channels())) {
+    cerr << "*** ERROR *** ";
+    cerr << "GuidedFilter needs a guide of the src size with one channel or "
+            "the channels of src"
+         << endl;
+    return false;
+  }
+
+  vector<cv::Mat> src_planes;
+  vector<cv::Mat> guide_planes;
+  cv::split(src, src_planes);
+  cv::split(guide, guide_planes);
+  vector<cv::Mat> dst_planes(src_planes.size());
+
+  ParallelFor(src_planes.size(), num_threads, [&](int begin, int end) {
+    for (int chan = begin; chan < end; chan++) {
+      cv::Mat p;
+      cv::Mat I;
+      src_planes[chan].convertTo(p, CV_64F);
+      guide_planes[guide_planes.size() == 1 ? 0 : chan].convertTo(I, CV_64F);
+      cv::Mat q;
+      FilterChannel(p, I, radius, epsilon, q);
+      q.convertTo(dst_planes[chan], src.depth());
+    }
+  });
+
+  cv::merge(dst_planes, dst);
+  return true;
+}
+} // namespace ipcv
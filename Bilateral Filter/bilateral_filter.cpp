@@ -1,4 +1,4 @@
-#include <ctime>
+#include <chrono>
 #include <iostream>
 
 #include <boost/filesystem.hpp>
@@ -21,6 +21,9 @@ int main(int argc, char* argv[]) {
   int filter_radius = -1;
   int value = 0;
   string border_mode_string = "constant";
+  string method = "exact";
+  double accuracy = 1;
+  bool report_psnr = false;
   ipcv::BorderMode border_mode;
 
   po::options_description options("Options");
@@ -37,8 +40,14 @@ int main(int argc, char* argv[]) {
       "filter radius (if negative, use twice the standard deviation of the "
       "distance filter) [default is -1]")(
       "border-mode,m", po::value<string>(&border_mode_string),
-      "border mode (constant|replicate) [default is constant]")(
-      "border-value,b", po::value<int>(&value), "border value [default is 0]");
+      "border mode (constant|replicate|reflect101) [default is constant]")(
+      "border-value,b", po::value<int>(&value), "border value [default is 0]")(
+      "method,M", po::value<string>(&method),
+      "filtering method (exact|grid|guided) [default is exact]")(
+      "accuracy,a", po::value<double>(&accuracy),
+      "bilateral grid cells per standard deviation [default is 1]")(
+      "psnr,p", po::bool_switch(&report_psnr),
+      "report the PSNR of the grid result against the exact filter");
 
   po::positional_options_description positional_options;
   positional_options.add("source-filename", -1);
@@ -71,12 +80,20 @@ if (border_mode_string == "constant") {
     border_mode = ipcv::BorderMode::CONSTANT;
   } else if (border_mode_string == "replicate") {
     border_mode = ipcv::BorderMode::REPLICATE;
+  } else if (border_mode_string == "reflect101") {
+    border_mode = ipcv::BorderMode::REFLECT_101;
   } else {
     cerr << "*** ERROR *** ";
     cerr << "Provided border mode is not supported" << endl;
     return EXIT_FAILURE;
   }
 
+  if (method != "exact" && method != "grid" && method != "guided") {
+    cerr << "*** ERROR *** ";
+    cerr << "Provided method is not supported" << endl;
+    return EXIT_FAILURE;
+  }
+
 
   if (verbose) {
     cout << "Source filename: " << src_filename << endl;
@@ -85,24 +102,48 @@ if (border_mode_string == "constant") {
     cout << "Distance filter standard deviation: " << sigma_distance << endl;
     cout << "Range filter standard deviation: " << sigma_range << endl;
     cout << "Filter radius: " << filter_radius << endl;
+    cout << "Method: " << method << endl;
+    if (method == "grid") {
+      cout << "Grid accuracy: " << accuracy << endl;
+    }
     cout << "Destination filename: " << dst_filename << endl;
   }
 
   cv::Mat dst;
 
-  clock_t startTime = clock();
-
-  ipcv::BilateralFilter(src, dst, sigma_distance, sigma_range, filter_radius,
-                        border_mode);
+  // Wall clock time, since the filters run on several threads
+  auto startTime = chrono::steady_clock::now();
+
+  if (method == "grid") {
+    ipcv::BilateralGrid(src, dst, sigma_distance, sigma_range, accuracy);
+  } else if (method == "guided") {
+    int radius = filter_radius;
+    if (radius < 0) {
+      radius = static_cast<int>(sigma_distance * 2);
+    }
+    ipcv::GuidedFilter(src, src, dst, radius,
+                       ipcv::GuidedFilterEpsilon(sigma_range));
+  } else {
+    ipcv::BilateralFilter(src, dst, sigma_distance, sigma_range,
+                          filter_radius, border_mode, value);
+  }
 
-  clock_t endTime = clock();
+  auto endTime = chrono::steady_clock::now();
 
   if (verbose) {
     cout << "Elapsed time: "
-         << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
+         << chrono::duration<double>(endTime - startTime).count()
          << " [s]" << endl;
   }
 
+  if (report_psnr) {
+    cout << "Grid PSNR against exact: "
+         << ipcv::BilateralGridPSNR(src, sigma_distance, sigma_range,
+                                    accuracy, filter_radius, border_mode,
+                                    value)
+         << " [dB]" << endl;
+  }
+
   if (dst_filename.empty()) {
     cv::imshow(src_filename, src);
     cv::imshow(src_filename + " [Bilateral Filtered]", dst);
@@ -8,6 +8,7 @@
 
 #include "Corners.h"
 
+#include "imgs/ipcv/spatial_filtering/Filter2D.h"
 #include "opencv2/imgproc.hpp"
 #include <iostream>
 #include <opencv2/core.hpp>
@@ -63,8 +64,14 @@ bool Harris(const cv::Mat &src, cv::Mat &dst, const float sigma,
   kernelV.at<float>(0, 2) = -1;
   kernelV.at<float>(2, 2) = 1;
   kernelV /= 1;
-  cv::filter2D(src_gray, Ix, CV_32FC1, kernelH);
-  cv::filter2D(src_gray, Iy, CV_32FC1, kernelV);
+  // Both gradients from a single pass over the source
+  vector<cv::Mat> gradients;
+  if (!ipcv::Filter2DBank(src_gray, {kernelH, kernelV}, gradients, CV_32F, 0,
+                          ipcv::BorderMode::REFLECT_101)) {
+    return false;
+  }
+  Ix = gradients[0];
+  Iy = gradients[1];
 
   // Create Hessian Matrix
   cv::Mat A;
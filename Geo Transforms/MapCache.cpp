@@ -0,0 +1,267 @@
+/** Implementation file for caching the maps of repeated geometric corrections
+ *
+ *  \file ipcv/geometric_transformation/MapCache.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "MapCache.h"
+
+#include <exception>
+
+#include "MapQ2Q.h"
+#include "MapRST.h"
+
+using namespace std;
+
+namespace ipcv {
+
+// Kinds of keyed requests, so equal parameters of different kinds differ
+enum class MapKind : uint8_t { RST, Q2Q, TRANSFORM };
+
+/** Appends the bytes of a value to a key */
+template <typename V>
+static void AppendKey(string &key, const V &value) {
+  key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+/** Key prefix shared by every kind of request */
+static string KeyPrefix(const MapKind kind, const cv::Size size,
+                        const Interpolation interpolation) {
+  string key;
+  AppendKey(key, kind);
+  AppendKey(key, size.width);
+  AppendKey(key, size.height);
+  AppendKey(key, interpolation);
+  return key;
+}
+
+/** Size of a map [bytes] */
+static size_t MapBytes(const FixedPointMap &map) {
+  return map.xy.total() * map.xy.elemSize() +
+         map.fraction.total() * map.fraction.elemSize();
+}
+
+/** Constructor
+ *
+ *  \param[in] byte_budget  largest total size of the cached maps [bytes]
+ *  \param[in] num_threads  number of worker threads maps are generated on
+ *                          (if less than 1, use the number of hardware
+ *                          threads)
+ */
+MapCache::MapCache(const size_t byte_budget, const int num_threads)
+    : budget_(byte_budget), num_threads_(num_threads) {}
+
+/** Map of a key, generated by generate on a miss
+ *
+ *  \param[in] key       key of the map
+ *  \param[in] generate  callable filling a FixedPointMap, returning false
+ *                       if it could not
+ */
+template <typename Generate>
+MapCache::MapPtr MapCache::Lookup(const string &key, Generate generate) {
+  promise<MapPtr> generated;
+  unique_lock<mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    hits_++;
+    lru_.splice(lru_.begin(), lru_, it->second);
+
+    // A map still being generated by another thread is waited for outside
+    // of the lock
+    shared_future<MapPtr> map = it->second->map;
+    lock.unlock();
+    return map.get();
+  }
+
+  // The entry is visible before its map exists, so concurrent requests for
+  // it wait instead of generating it too
+  misses_++;
+  lru_.push_front(Entry{key, generated.get_future().share(), 0, false});
+  index_[key] = lru_.begin();
+  lock.unlock();
+
+  // A failed or throwing generation removes the entry, so later requests
+  // try again; waiting requests get the same result or exception
+  MapPtr result;
+  try {
+    auto map = make_shared<FixedPointMap>();
+    result = generate(*map) ? map : nullptr;
+  } catch (...) {
+    generated.set_exception(current_exception());
+    lock.lock();
+    it = index_.find(key);
+    if (it != index_.end()) {
+      lru_.erase(it->second);
+      index_.erase(it);
+    }
+    throw;
+  }
+  generated.set_value(result);
+
+  lock.lock();
+  it = index_.find(key);
+  if (it != index_.end()) {
+    if (result == nullptr) {
+      lru_.erase(it->second);
+      index_.erase(it);
+    } else {
+      it->second->bytes = MapBytes(*result);
+      it->second->ready = true;
+      bytes_ += it->second->bytes;
+      Evict();
+    }
+  }
+  return result;
+}
+
+/** Evict least recently used, generated maps down to the budget; the mutex
+ *  must be held
+ */
+void MapCache::Evict() {
+  auto it = lru_.end();
+  while (bytes_ > budget_ && it != lru_.begin()) {
+    --it;
+    if (!it->ready) {
+      continue;
+    }
+    bytes_ -= it->bytes;
+    index_.erase(it->key);
+    it = lru_.erase(it);
+  }
+}
+
+/** Map of an RST transformation, as MapRST finds it
+ *
+ *  \param[in] src_size       size of the source
+ *  \param[in] angle          rotation angle (CCW) [radians]
+ *  \param[in] scale_x        horizontal scale
+ *  \param[in] scale_y        vertical scale
+ *  \param[in] translation_x  horizontal translation [+ right]
+ *  \param[in] translation_y  vertical translation [+ up]
+ *  \param[in] interpolation  interpolation the map will be used with
+ *
+ *  \return                   map, or nullptr if it could not be found
+ */
+MapCache::MapPtr MapCache::RST(const cv::Size src_size, const double angle,
+                               const double scale_x, const double scale_y,
+                               const double translation_x,
+                               const double translation_y,
+                               const Interpolation interpolation) {
+  string key = KeyPrefix(MapKind::RST, src_size, interpolation);
+  AppendKey(key, angle);
+  AppendKey(key, scale_x);
+  AppendKey(key, scale_y);
+  AppendKey(key, translation_x);
+  AppendKey(key, translation_y);
+  return Lookup(key, [&](FixedPointMap &map) {
+    cv::Size map_size;
+    Transform transform;
+    return RSTTransform(src_size, angle, scale_x, scale_y, translation_x,
+                        translation_y, map_size, transform) &&
+           ConvertTransform(transform, map_size, map, interpolation,
+                            num_threads_);
+  });
+}
+
+/** Map of a quad to quad mapping, as MapQ2Q finds it
+ *
+ *  \param[in] tgt_size       size of the target (destination map)
+ *  \param[in] src_vertices   vertices of the source quadrilateral (CW)
+ *  \param[in] tgt_vertices   vertices of the target quadrilateral (CW)
+ *  \param[in] interpolation  interpolation the map will be used with
+ *
+ *  \return                   map, or nullptr if it could not be found
+ */
+MapCache::MapPtr MapCache::Q2Q(const cv::Size tgt_size,
+                               const vector<cv::Point> &src_vertices,
+                               const vector<cv::Point> &tgt_vertices,
+                               const Interpolation interpolation) {
+  string key = KeyPrefix(MapKind::Q2Q, tgt_size, interpolation);
+  for (const vector<cv::Point> *vertices : {&src_vertices, &tgt_vertices}) {
+    AppendKey(key, vertices->size());
+    for (const cv::Point &p : *vertices) {
+      AppendKey(key, p.x);
+      AppendKey(key, p.y);
+    }
+  }
+  return Lookup(key, [&](FixedPointMap &map) {
+    Transform transform;
+    return Q2QTransform(src_vertices, tgt_vertices, transform) &&
+           ConvertTransform(transform, tgt_size, map, interpolation,
+                            num_threads_);
+  });
+}
+
+/** Map of any transformation
+ *
+ *  \param[in] map_size       size of the destination map
+ *  \param[in] transform      destination to source transformation
+ *  \param[in] interpolation  interpolation the map will be used with
+ *
+ *  \return                   map, or nullptr if it could not be found
+ */
+MapCache::MapPtr MapCache::Map(const cv::Size map_size,
+                               const Transform &transform,
+                               const Interpolation interpolation) {
+  // Coefficients are keyed by value in double precision, whatever their
+  // type
+  cv::Mat coefficients;
+  transform.coefficients.convertTo(coefficients, CV_64F);
+  string key = KeyPrefix(MapKind::TRANSFORM, map_size, interpolation);
+  AppendKey(key, transform.type);
+  if (transform.type == TransformType::POLYNOMIAL) {
+    AppendKey(key, transform.order);
+  }
+  AppendKey(key, coefficients.rows);
+  AppendKey(key, coefficients.cols);
+  for (int r = 0; r < coefficients.rows; r++) {
+    key.append(reinterpret_cast<const char *>(coefficients.ptr<double>(r)),
+               coefficients.cols * sizeof(double));
+  }
+  return Lookup(key, [&](FixedPointMap &map) {
+    return ConvertTransform(transform, map_size, map, interpolation,
+                            num_threads_);
+  });
+}
+
+/** Number of requests answered from the cache */
+size_t MapCache::Hits() const {
+  lock_guard<mutex> lock(mutex_);
+  return hits_;
+}
+
+/** Number of requests that generated their map */
+size_t MapCache::Misses() const {
+  lock_guard<mutex> lock(mutex_);
+  return misses_;
+}
+
+/** Total size of the cached maps [bytes] */
+size_t MapCache::Bytes() const {
+  lock_guard<mutex> lock(mutex_);
+  return bytes_;
+}
+
+/** Change the byte budget, evicting maps down to it */
+void MapCache::SetBudget(const size_t byte_budget) {
+  lock_guard<mutex> lock(mutex_);
+  budget_ = byte_budget;
+  Evict();
+}
+
+/** Release every cached map (maps in use stay valid) */
+void MapCache::Clear() {
+  lock_guard<mutex> lock(mutex_);
+  bytes_ = 0;
+  auto it = lru_.begin();
+  while (it != lru_.end()) {
+    if (it->ready) {
+      index_.erase(it->key);
+      it = lru_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+} // namespace ipcv
@@ -0,0 +1,140 @@
+/** Interface file for caching the maps of repeated geometric corrections
+ *
+ *  \file ipcv/geometric_transformation/MapCache.h
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "Remap.h"
+#include "Warp.h"
+
+namespace ipcv {
+
+/** Least recently used cache of fixed point maps, keyed by the
+ *  transformation and its parameters, source and destination sizes and
+ *  interpolation
+ *
+ *  A video pipeline correcting every frame with the same parameters finds
+ *  the map once and remaps every later frame with the cached one.  Maps
+ *  are kept in the FixedPointMap format (6 bytes per pixel instead of 8),
+ *  and the least recently used ones are released once their total size
+ *  exceeds the byte budget.
+ *
+ *  The cache is safe to share between threads.  Maps are returned as
+ *  shared pointers, so an evicted map stays valid while it is in use, and
+ *  a map requested while another thread generates it is waited for rather
+ *  than generated twice.
+ */
+class MapCache {
+ public:
+  /** Constructor
+   *
+   *  \param[in] byte_budget  largest total size of the cached maps [bytes]
+   *  \param[in] num_threads  number of worker threads maps are generated on
+   *                          (if less than 1, use the number of hardware
+   *                          threads)
+   */
+  explicit MapCache(const size_t byte_budget = size_t(256) << 20,
+                    const int num_threads = 0);
+
+  /** Map of an RST transformation, as MapRST finds it
+   *
+   *  \param[in] src_size       size of the source
+   *  \param[in] angle          rotation angle (CCW) [radians]
+   *  \param[in] scale_x        horizontal scale
+   *  \param[in] scale_y        vertical scale
+   *  \param[in] translation_x  horizontal translation [+ right]
+   *  \param[in] translation_y  vertical translation [+ up]
+   *  \param[in] interpolation  interpolation the map will be used with
+   *
+   *  \return                   map, or nullptr if it could not be found
+   */
+  std::shared_ptr<const FixedPointMap> RST(
+      const cv::Size src_size, const double angle, const double scale_x,
+      const double scale_y, const double translation_x,
+      const double translation_y,
+      const Interpolation interpolation = Interpolation::LINEAR);
+
+  /** Map of a quad to quad mapping, as MapQ2Q finds it
+   *
+   *  \param[in] tgt_size       size of the target (destination map)
+   *  \param[in] src_vertices   vertices of the source quadrilateral (CW)
+   *  \param[in] tgt_vertices   vertices of the target quadrilateral (CW)
+   *  \param[in] interpolation  interpolation the map will be used with
+   *
+   *  \return                   map, or nullptr if it could not be found
+   */
+  std::shared_ptr<const FixedPointMap> Q2Q(
+      const cv::Size tgt_size, const std::vector<cv::Point>& src_vertices,
+      const std::vector<cv::Point>& tgt_vertices,
+      const Interpolation interpolation = Interpolation::LINEAR);
+
+  /** Map of any transformation
+   *
+   *  \param[in] map_size       size of the destination map
+   *  \param[in] transform      destination to source transformation
+   *  \param[in] interpolation  interpolation the map will be used with
+   *
+   *  \return                   map, or nullptr if it could not be found
+   */
+  std::shared_ptr<const FixedPointMap> Map(
+      const cv::Size map_size, const Transform& transform,
+      const Interpolation interpolation = Interpolation::LINEAR);
+
+  /** Number of requests answered from the cache */
+  size_t Hits() const;
+
+  /** Number of requests that generated their map */
+  size_t Misses() const;
+
+  /** Total size of the cached maps [bytes] */
+  size_t Bytes() const;
+
+  /** Change the byte budget, evicting maps down to it */
+  void SetBudget(const size_t byte_budget);
+
+  /** Release every cached map (maps in use stay valid) */
+  void Clear();
+
+ private:
+  using MapPtr = std::shared_ptr<const FixedPointMap>;
+
+  struct Entry {
+    std::string key;
+    std::shared_future<MapPtr> map;
+    size_t bytes;
+    bool ready;
+  };
+
+  /** Map of a key, generated by generate on a miss */
+  template <typename Generate>
+  MapPtr Lookup(const std::string& key, Generate generate);
+
+  /** Evict least recently used, generated maps down to the budget; the
+   *  mutex must be held
+   */
+  void Evict();
+
+  mutable std::mutex mutex_;
+  size_t budget_;
+  int num_threads_;
+  size_t bytes_ = 0;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+  std::list<Entry> lru_; // most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+}
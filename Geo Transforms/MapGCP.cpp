@@ -9,15 +9,168 @@
 
 #include "MapGCP.h"
 
+#include <cmath>
 #include <iostream>
 
 #include <eigen3/Eigen/Dense>
 #include <opencv2/core.hpp>
 
+#include "imgs/ipcv/utils/Parallel.h"
+
 using namespace std;
 
 namespace ipcv {
 
+/** Number of terms of a mapping polynomial of an order */
+static int PolynomialTerms(const int order) {
+  return (order + 1) * (order + 2) / 2;
+}
+
+/** Terms of a mapping polynomial at (x, y), in the MapGCP order
+ *
+ *  \param[in] x      horizontal coordinate
+ *  \param[in] y      vertical coordinate
+ *  \param[in] order  mapping polynomial order
+ *  \param[out] terms (order + 1)(order + 2) / 2 terms
+ */
+static void PolynomialRow(const double x, const double y, const int order,
+                          double *terms) {
+  int term = 0;
+  double y_power = 1;
+  for (int j = 0; j <= order; j++) {
+    double power = y_power;
+    for (int i = 0; i <= order - j; i++) {
+      terms[term++] = power;
+      power *= x;
+    }
+    y_power *= y;
+  }
+}
+
+/** Find the mapping polynomial of ground control points by least squares
+ *
+ *  \param[in] src_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the source image
+ *  \param[in] map_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the map image
+ *  \param[in] order  mapping polynomial order (1, 2 or 3)
+ *  \param[out] transform
+ *                    POLYNOMIAL transformation from map (x, y) to the
+ *                    source coordinates map1, map2 hold
+ *  \param[out] residuals
+ *                    distance between each source point and its mapped map
+ *                    point [pixels]
+ *  \param[out] rms   root mean square of the residuals [pixels]
+ */
+bool GCPTransform(const vector<cv::Point> &src_points,
+                  const vector<cv::Point> &map_points, const int order,
+                  Transform &transform, vector<double> &residuals,
+                  double &rms) {
+  int num_points = static_cast<int>(src_points.size());
+  int num_terms = PolynomialTerms(order);
+  if (order < 1 || order > 3) {
+    cerr << "*** ERROR *** ";
+    cerr << "GCPTransform supports polynomial orders 1, 2 and 3" << endl;
+    return false;
+  }
+  if (static_cast<int>(map_points.size()) != num_points ||
+      num_points < num_terms) {
+    cerr << "*** ERROR *** ";
+    cerr << "GCPTransform needs as many source as map points, and at least "
+         << num_terms << " of them for order " << order << endl;
+    return false;
+  }
+
+  // Design matrix of the map points, and the source points it is fitted to
+  Eigen::MatrixXd x_bar(num_points, num_terms);
+  Eigen::MatrixXd y_bar(num_points, 2);
+  double terms[10];
+  for (int idx = 0; idx < num_points; idx++) {
+    PolynomialRow(map_points[idx].x, map_points[idx].y, order, terms);
+    for (int k = 0; k < num_terms; k++) {
+      x_bar(idx, k) = terms[k];
+    }
+    y_bar(idx, 0) = src_points[idx].x;
+    y_bar(idx, 1) = src_points[idx].y;
+  }
+
+  // The columns span many orders of magnitude (x^3 of a 30k map is 1e13),
+  // so they are equilibrated before one QR solve for both coordinates,
+  // rather than forming the normal equations
+  Eigen::VectorXd column_scale = x_bar.colwise().norm().transpose();
+  for (int k = 0; k < num_terms; k++) {
+    if (column_scale(k) == 0) {
+      column_scale(k) = 1;
+    }
+  }
+  Eigen::MatrixXd scaled = x_bar * column_scale.cwiseInverse().asDiagonal();
+  Eigen::MatrixXd C = scaled.colPivHouseholderQr().solve(y_bar);
+  C = column_scale.cwiseInverse().asDiagonal() * C;
+
+  transform.type = TransformType::POLYNOMIAL;
+  transform.order = order;
+  transform.coefficients.create(2, num_terms, CV_64FC1);
+  for (int k = 0; k < num_terms; k++) {
+    transform.coefficients.at<double>(0, k) = C(k, 0);
+    transform.coefficients.at<double>(1, k) = C(k, 1);
+  }
+
+  Eigen::MatrixXd error = x_bar * C - y_bar;
+  residuals.resize(num_points);
+  double sum = 0;
+  for (int idx = 0; idx < num_points; idx++) {
+    residuals[idx] = error.row(idx).norm();
+    sum += residuals[idx] * residuals[idx];
+  }
+  rms = sqrt(sum / num_points);
+
+  return true;
+}
+
+/** Evaluates both coordinates of a mapping polynomial along a map row
+ *
+ *  The polynomial collapses to one in x alone for the row, evaluated per
+ *  pixel in Horner form; with the order known at compile time the pixels
+ *  are independent and the loop vectorizes.
+ *
+ *  \param[in] coefficients  2 x terms CV_64F polynomial coefficients
+ *  \param[in] row           map row
+ *  \param[in] cols          number of map columns
+ *  \param[out] map_x        cols horizontal source coordinates
+ *  \param[out] map_y        cols vertical source coordinates
+ */
+template <int kOrder>
+static void EvaluateRow(const cv::Mat &coefficients, const int row,
+                        const int cols, float *map_x, float *map_y) {
+  double cx[kOrder + 1] = {};
+  double cy[kOrder + 1] = {};
+  const double *ax = coefficients.ptr<double>(0);
+  const double *ay = coefficients.ptr<double>(1);
+  int term = 0;
+  double y_power = 1;
+  for (int j = 0; j <= kOrder; j++) {
+    for (int i = 0; i <= kOrder - j; i++, term++) {
+      cx[i] += ax[term] * y_power;
+      cy[i] += ay[term] * y_power;
+    }
+    y_power *= row;
+  }
+
+  for (int c = 0; c < cols; c++) {
+    double x = c;
+    double sx = cx[kOrder];
+    double sy = cy[kOrder];
+    for (int i = kOrder - 1; i >= 0; i--) {
+      sx = sx * x + cx[i];
+      sy = sy * x + cy[i];
+    }
+    map_x[c] = static_cast<float>(sx);
+    map_y[c] = static_cast<float>(sy);
+  }
+}
+
 /** Find the source coordinates (map1, map2) for a ground control point
  *  derived mapping polynomial transformation
  *
@@ -49,85 +202,49 @@ namespace ipcv {
  *  \param[out] map2  cv::Mat of CV_32FC1 (size of the destination map)
  *                    containing the vertical (y) coordinates at which to
  *                    resample the source data
+ *  \param[in] num_threads
+ *                    number of worker threads the rows are distributed over
+ *                    (if less than 1, use the number of hardware threads)
  */
 bool MapGCP(const cv::Mat src, const cv::Mat map,
             const vector<cv::Point> src_points,
             const vector<cv::Point> map_points, const int order,
-            cv::Mat& map1, cv::Mat& map2) {
-
-//Create Maps
-map1.create(map.size(), CV_32FC1);
-map2.create(map.size(), CV_32FC1);
-
-//Create y_bar and x_bar matrices for first 3 orders
- Eigen::MatrixXf y_bar(src_points.size(), 2);
-  Eigen::MatrixXf xbar_1(src_points.size(),3);
-  Eigen::MatrixXf xbar_2(src_points.size(),6);
-  Eigen::MatrixXf xbar_3(src_points.size(),10);
-
-//define coefficient matrix
-  Eigen::MatrixXf C;
-  Eigen::VectorXf Input(2);
-  Eigen::VectorXf Output(3);
-
-  // create y_bar matrix of src points
-  for (int idx = 0; idx < static_cast<int>(src_points.size()); idx++) {
-    y_bar(idx,0) = src_points[idx].x;
-    y_bar(idx,1) = src_points[idx].y;
+            cv::Mat& map1, cv::Mat& map2, const int num_threads) {
+  Transform transform;
+  vector<double> residuals;
+  double rms;
+  if (!GCPTransform(src_points, map_points, order, transform, residuals,
+                    rms)) {
+    return false;
   }
 
-  for (int idx = 0; idx < static_cast<int>(map_points.size()); idx++) {
-    int x = map_points[idx].x;
-    int y = map_points[idx].y;
-//first order
-    if (order == 1) {
-      xbar_1(idx,0) = (x^0 * y^0);
-      xbar_1(idx,1) = (x^1 * y^0);
-      xbar_1(idx,2) = (x^0 * y^1);
-      C = (xbar_1.transpose() * xbar_1).inverse() * xbar_1.transpose() * y_bar;
-      Input(0) = x;
-      Input(1) = y;
-      Output = C * Input;
-      cout << Input << endl;
-      cout << endl;
-      cout << Output << endl;
-      cout << endl;
-      map1.at<float>(x, y) = Output(1);
-      map2.at<float>(x, y) = Output(0);
-//second order
-    } else if (order == 2) {
-      xbar_2(idx,0) = (x^0 * y^0);
-      xbar_2(idx,1) = (x^1 * y^0);
-      xbar_2(idx,2) = (x^2 * y^0);
-      xbar_2(idx,3) = (x^0 * y^1);
-      xbar_2(idx,4) = (x^1 * y^1);
-      xbar_2(idx,5) = (x^0 * y^2);
-      C = (xbar_2.transpose() * xbar_2).inverse() * xbar_2.transpose() * y_bar;
-      Input(0) = x;
-      Input(1) = y;
-      Output = C * Input;
-      map1.at<float>(x, y) = Output(1);
-      map2.at<float>(x, y) = Output(0);
-//third order
-    } else if (order == 3) {
-      xbar_3(idx,0) = (x^0 * y^0);
-      xbar_3(idx,1) = (x^1 * y^0);
-      xbar_3(idx,2) = (x^2 * y^0);
-      xbar_3(idx,3) = (x^3 * y^0);
-      xbar_3(idx,4) = (x^0 * y^1);
-      xbar_3(idx,5) = (x^1 * y^1);
-      xbar_3(idx,6) = (x^2 * y^1);
-      xbar_3(idx,7) = (x^0 * y^2);
-      xbar_3(idx,8) = (x^1 * y^2);
-      xbar_3(idx,9) = (x^0 * y^3);
-      C = (xbar_3.transpose() * xbar_3).inverse() * xbar_3.transpose() * y_bar;
-      Input(0) = x;
-      Input(1) = y;
-      Output = C * Input;
-      map1.at<float>(x, y) = Output(1);
-      map2.at<float>(x, y) = Output(0);
-    }
-  }
+  //Create Maps
+  map1.create(map.size(), CV_32FC1);
+  map2.create(map.size(), CV_32FC1);
+
+  ParallelFor(
+      map1.rows, num_threads,
+      [&](int begin, int end) {
+        for (int r = begin; r < end; r++) {
+          float *map_x = map1.ptr<float>(r);
+          float *map_y = map2.ptr<float>(r);
+          switch (order) {
+          case 1:
+            EvaluateRow<1>(transform.coefficients, r, map1.cols, map_x,
+                           map_y);
+            break;
+          case 2:
+            EvaluateRow<2>(transform.coefficients, r, map1.cols, map_x,
+                           map_y);
+            break;
+          default:
+            EvaluateRow<3>(transform.coefficients, r, map1.cols, map_x,
+                           map_y);
+          }
+        }
+      },
+      16);
+
   return true;
 }
 }
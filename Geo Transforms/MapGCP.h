@@ -0,0 +1,117 @@
+/** Interface file for finding source image coordinates for a source-to-map
+ *  remapping using ground control points
+ *
+ *  \file ipcv/geometric_transformation/MapGCP.h
+ *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
+ *  \edited Andrea Avendano (aa6588@rit.edu)
+ *  \date 26 Sept 2020
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "Warp.h"
+
+namespace ipcv {
+
+/** Find the mapping polynomial of ground control points by least squares
+ *
+ *  The polynomial is solved once, by a QR decomposition of the column
+ *  equilibrated design matrix, and can be given to Warp or evaluated over a
+ *  map by MapGCP.  Residuals show which ground control points fit poorly.
+ *
+ *  \param[in] src_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the source image
+ *  \param[in] map_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the map image
+ *  \param[in] order  mapping polynomial order (1, 2 or 3)
+ *  \param[out] transform
+ *                    POLYNOMIAL transformation from map (x, y) to the
+ *                    source coordinates map1, map2 hold
+ *  \param[out] residuals
+ *                    distance between each source point and its mapped map
+ *                    point [pixels]
+ *  \param[out] rms   root mean square of the residuals [pixels]
+ */
+bool GCPTransform(const std::vector<cv::Point>& src_points,
+                  const std::vector<cv::Point>& map_points, const int order,
+                  Transform& transform, std::vector<double>& residuals,
+                  double& rms);
+
+/** Fit a transformation to ground control points with RANSAC, refining
+ *  each new best hypothesis on its inliers (LO-RANSAC)
+ *
+ *  Hypotheses are fitted to random minimal samples and scored in parallel,
+ *  and drawing stops once the inlier ratio of the best one makes an
+ *  outlier free sample likely enough.  The result is fitted to all of the
+ *  inliers, so gross outliers among automatically matched points do not
+ *  pull it off.
+ *
+ *  \param[in] src_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the source image
+ *  \param[in] map_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the map image
+ *  \param[in] type  AFFINE, PROJECTIVE or POLYNOMIAL
+ *  \param[in] order  mapping polynomial order (1, 2 or 3, POLYNOMIAL only)
+ *  \param[in] threshold
+ *                    largest distance between a source point and its
+ *                    mapped map point for an inlier [pixels]
+ *  \param[out] transform
+ *                    transformation from map (x, y) to the source
+ *                    coordinates map1, map2 hold, fitted to the inliers
+ *  \param[out] inliers
+ *                    mask of the inlying ground control points, which the
+ *                    result is fitted to (1 inlier, 0 outlier)
+ *  \param[in] confidence
+ *                    probability of drawing at least one outlier free
+ *                    sample before stopping
+ *  \param[in] max_iterations
+ *                    largest number of hypotheses drawn
+ *  \param[in] num_threads
+ *                    number of worker threads the hypotheses are evaluated
+ *                    on (if less than 1, use the number of hardware threads)
+ *  \param[in] seed   seed of the random samples
+ */
+bool RansacGCPTransform(const std::vector<cv::Point>& src_points,
+                        const std::vector<cv::Point>& map_points,
+                        const TransformType type, const int order,
+                        const double threshold, Transform& transform,
+                        std::vector<uint8_t>& inliers,
+                        const double confidence = 0.999,
+                        const int max_iterations = 10000,
+                        const int num_threads = 0, const unsigned seed = 0);
+
+/** Find the source coordinates (map1, map2) for a ground control point
+ *  derived mapping polynomial transformation
+ *
+ *  \param[in] src   source cv::Mat of CV_8UC3
+ *  \param[in] map   map (target) cv::Mat of CV_8UC3
+ *  \param[in] src_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the source image
+ *  \param[in] map_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the map image
+ *  \param[in] order  mapping polynomial order (1, 2 or 3)
+ *  \param[out] map1  cv::Mat of CV_32FC1 (size of the destination map)
+ *                    containing the horizontal (x) coordinates at which to
+ *                    resample the source data
+ *  \param[out] map2  cv::Mat of CV_32FC1 (size of the destination map)
+ *                    containing the vertical (y) coordinates at which to
+ *                    resample the source data
+ *  \param[in] num_threads
+ *                    number of worker threads the rows are distributed over
+ *                    (if less than 1, use the number of hardware threads)
+ */
+bool MapGCP(const cv::Mat src, const cv::Mat map,
+            const std::vector<cv::Point> src_points,
+            const std::vector<cv::Point> map_points, const int order,
+            cv::Mat& map1, cv::Mat& map2, const int num_threads = 0);
+}
@@ -3,7 +3,7 @@
  *  \file ipcv/geometric_transformation/MapQ2Q.cpp
  *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
  *  \edited: Andrea Avendano (aa6588@rit.edu)
- *  \date 3 October 
+ *  \date 3 October
  */
 
 #include "MapQ2Q.h"
@@ -13,10 +13,144 @@
 #include <eigen3/Eigen/Dense>
 #include <opencv2/core.hpp>
 
+#include "imgs/ipcv/utils/Parallel.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 namespace ipcv {
 
+/** Matrix taking the basis vectors to the homogeneous vertices of a quad
+ *
+ *  \param[in] vertices  4 vertices of the quadrilateral
+ *
+ *  \return              3 x 3 matrix of the weighted vertices in columns,
+ *                       the fourth vertex being their sum
+ */
+static Eigen::Matrix3d QuadBasis(const vector<cv::Point> &vertices) {
+  // Create matrix from points
+  Eigen::Matrix3d inverse;
+  for (int i = 0; i < 3; i++) {
+    inverse(0, i) = vertices[i].x;
+    inverse(1, i) = vertices[i].y;
+    inverse(2, i) = 1;
+  }
+  // right hand side of equation
+  Eigen::Vector3d rhs(vertices[3].x, vertices[3].y, 1);
+
+  // Create scaling values
+  Eigen::Vector3d weights = inverse.inverse() * rhs;
+
+  Eigen::Matrix3d basis;
+  for (int i = 0; i < 3; i++) {
+    basis(0, i) = weights(i) * vertices[i].x;
+    basis(1, i) = weights(i) * vertices[i].y;
+    basis(2, i) = weights(i);
+  }
+  return basis;
+}
+
+/** Find the homography of a quad to quad mapping
+ *
+ *  \param[in] src_vertices
+ *                       vertices cv:Point of the source quadrilateral (CW)
+ *                       which is to be mapped to the target quadrilateral
+ *  \param[in] tgt_vertices
+ *                       vertices cv:Point of the target quadrilateral (CW)
+ *                       into which the source quadrilateral is to be mapped
+ *  \param[out] transform
+ *                       PROJECTIVE transformation from target (x, y) to the
+ *                       source coordinates map1, map2 hold
+ */
+bool Q2QTransform(const vector<cv::Point> &src_vertices,
+                  const vector<cv::Point> &tgt_vertices,
+                  Transform &transform) {
+  if (src_vertices.size() != 4 || tgt_vertices.size() != 4) {
+    cerr << "*** ERROR *** ";
+    cerr << "Q2QTransform needs 4 source and 4 target vertices" << endl;
+    return false;
+  }
+
+  // B takes the basis to the source, A to the target, so B A^-1 takes the
+  // target (x, y) to the source (x, y)
+  Eigen::Matrix3d B = QuadBasis(src_vertices);
+  Eigen::Matrix3d A = QuadBasis(tgt_vertices);
+  Eigen::Matrix3d Pms = B * A.inverse();
+
+  transform.type = TransformType::PROJECTIVE;
+  transform.order = 1;
+  transform.coefficients.create(3, 3, CV_64FC1);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      transform.coefficients.at<double>(i, j) = Pms(i, j);
+    }
+  }
+  return true;
+}
+
+/** Fills one row of the maps of a homography
+ *
+ *  \param[in] h         3 x 3 homography, row major
+ *  \param[in] row       map row
+ *  \param[in] cols      number of map columns
+ *  \param[out] map_x    cols horizontal source coordinates
+ *  \param[out] map_y    cols vertical source coordinates
+ */
+static void ProjectRow(const double *h, const int row, const int cols,
+                       float *map_x, float *map_y) {
+  // The homogeneous coordinates advance by the first column of h along the
+  // row, leaving one division per pixel
+  double sx = h[1] * row + h[2];
+  double sy = h[4] * row + h[5];
+  double sw = h[7] * row + h[8];
+  int c = 0;
+
+#if defined(__AVX__)
+  // Blocks of 8 pixels are two vectors of 4 doubles each, which keeps the
+  // accuracy of the scalar path on large frames
+  const __m256d lanes_lo = _mm256_setr_pd(0, 1, 2, 3);
+  const __m256d lanes_hi = _mm256_setr_pd(4, 5, 6, 7);
+  __m256d x_lo = _mm256_add_pd(_mm256_set1_pd(sx),
+                               _mm256_mul_pd(lanes_lo, _mm256_set1_pd(h[0])));
+  __m256d x_hi = _mm256_add_pd(_mm256_set1_pd(sx),
+                               _mm256_mul_pd(lanes_hi, _mm256_set1_pd(h[0])));
+  __m256d y_lo = _mm256_add_pd(_mm256_set1_pd(sy),
+                               _mm256_mul_pd(lanes_lo, _mm256_set1_pd(h[3])));
+  __m256d y_hi = _mm256_add_pd(_mm256_set1_pd(sy),
+                               _mm256_mul_pd(lanes_hi, _mm256_set1_pd(h[3])));
+  __m256d w_lo = _mm256_add_pd(_mm256_set1_pd(sw),
+                               _mm256_mul_pd(lanes_lo, _mm256_set1_pd(h[6])));
+  __m256d w_hi = _mm256_add_pd(_mm256_set1_pd(sw),
+                               _mm256_mul_pd(lanes_hi, _mm256_set1_pd(h[6])));
+  const __m256d step_x = _mm256_set1_pd(8 * h[0]);
+  const __m256d step_y = _mm256_set1_pd(8 * h[3]);
+  const __m256d step_w = _mm256_set1_pd(8 * h[6]);
+  for (; c + 8 <= cols; c += 8) {
+    __m256 x = _mm256_set_m128(_mm256_cvtpd_ps(_mm256_div_pd(x_hi, w_hi)),
+                               _mm256_cvtpd_ps(_mm256_div_pd(x_lo, w_lo)));
+    __m256 y = _mm256_set_m128(_mm256_cvtpd_ps(_mm256_div_pd(y_hi, w_hi)),
+                               _mm256_cvtpd_ps(_mm256_div_pd(y_lo, w_lo)));
+    _mm256_storeu_ps(map_x + c, x);
+    _mm256_storeu_ps(map_y + c, y);
+    x_lo = _mm256_add_pd(x_lo, step_x);
+    x_hi = _mm256_add_pd(x_hi, step_x);
+    y_lo = _mm256_add_pd(y_lo, step_y);
+    y_hi = _mm256_add_pd(y_hi, step_y);
+    w_lo = _mm256_add_pd(w_lo, step_w);
+    w_hi = _mm256_add_pd(w_hi, step_w);
+  }
+#endif
+
+  for (; c < cols; c++) {
+    double w = sw + h[6] * c;
+    map_x[c] = static_cast<float>((sx + h[0] * c) / w);
+    map_y[c] = static_cast<float>((sy + h[3] * c) / w);
+  }
+}
+
 /** Find the source coordinates (map1, map2) for a quad to quad mapping
  *
  *  \param[in] src       source cv::Mat of CV_8UC3
@@ -33,80 +167,34 @@ namespace ipcv {
  *  \param[out] map2     cv::Mat of CV_32FC1 (size of the destination map)
  *                       containing the vertical (y) coordinates at
  *                       which to resample the source data
+ *  \param[in] num_threads
+ *                       number of worker threads the rows are distributed
+ *                       over (if less than 1, use the number of hardware
+ *                       threads)
  */
 bool MapQ2Q(const cv::Mat src, const cv::Mat tgt,
             const vector<cv::Point> src_vertices,
              vector<cv::Point> tgt_vertices, cv::Mat &map1,
-            cv::Mat &map2) {
-
-  // Create src matrix from points
-  Eigen::MatrixXf weights(3, 1);
-  Eigen::MatrixXf src_inverse(3, 3);
-  int src_size = src_vertices.size();
-
-  for (int i = 0; i < src_size - 1; i++) {
-    src_inverse(0, i) = src_vertices[i].x;
-    src_inverse(1, i) = src_vertices[i].y;
-    src_inverse(2, i) = 1;
+            cv::Mat &map2, const int num_threads) {
+  Transform transform;
+  if (!Q2QTransform(src_vertices, tgt_vertices, transform)) {
+    return false;
   }
-  //right hand side of equation
-  Eigen::MatrixXf src_rhs(3, 1);
-  src_rhs << src_vertices[3].x, src_vertices[3].y, 1;
-
-  //create scaling values for src
-  weights = src_inverse.inverse() * src_rhs;
-
-  // make B matrix (src to vector space)
-  Eigen::MatrixXf B(3, 3);
-  B << weights(0) * src_vertices[0].y, weights(1) * src_vertices[1].y, weights(2) * src_vertices[2].y, 
-      weights(0) * src_vertices[0].x, weights(1) * src_vertices[1].x, weights(2) * src_vertices[2].x,
-      weights(0), weights(1), weights(2);
-
-  // Create map matrix from tgt points
-  Eigen::MatrixXf weights_prime(3, 1);
-  Eigen::MatrixXf map_inverse(3, 3);
-  int map_size = tgt_vertices.size();
-
-  for (int ii = 0; ii < map_size - 1; ii++) {
-    map_inverse(0, ii) = tgt_vertices[ii].x;
-    map_inverse(1, ii) = tgt_vertices[ii].y;
-    map_inverse(2, ii) = 1;
-  }
-
-  //right hand side of equation
-  Eigen::MatrixXf map_rhs(3, 1);
-  map_rhs << tgt_vertices[3].x, tgt_vertices[3].y, 1;
 
-  //Create scaling values for map
-  weights_prime = map_inverse.inverse() * map_rhs;
-
-  // make A matrix (map to vector space)
-  Eigen::MatrixXf A(3, 3);
-  A <<  weights_prime(0) * tgt_vertices[0].x, weights_prime(1) * tgt_vertices[1].x, weights_prime(2) * tgt_vertices[2].x,
-        weights_prime(0) * tgt_vertices[0].y, weights_prime(1) * tgt_vertices[1].y, weights_prime(2) * tgt_vertices[2].y, 
-        weights_prime(0), weights_prime(1), weights_prime(2);
-
-  //Create perspective transformation matrix
-  Eigen::MatrixXf Pms = B * A.inverse();
-
-  //Create maps 
+  //Create maps
   map1.create(tgt.size(), CV_32FC1);
   map2.create(tgt.size(), CV_32FC1);
 
   //Apply perspective transformation matrix to the image
-  Eigen::MatrixXf src_points(3, 1);
-  Eigen::MatrixXf map_points(3, 1);
-
-  for (int r = 0; r < map1.rows; r++) {
-    for (int c = 0; c < map1.cols; c++) {
-      map_points(0, 0) = c;
-      map_points(1, 0) = r;
-      map_points(2, 0) = 1;
-      src_points = Pms * map_points;
-      map1.at<float>(r, c) = src_points(1) / src_points(2);
-      map2.at<float>(r, c) = src_points(0) / src_points(2);
-    }
-  }
+  const double *h = transform.coefficients.ptr<double>(0);
+  ParallelFor(
+      map1.rows, num_threads,
+      [&](int begin, int end) {
+        for (int r = begin; r < end; r++) {
+          ProjectRow(h, r, map1.cols, map1.ptr<float>(r), map2.ptr<float>(r));
+        }
+      },
+      16);
 
   return true;
 }
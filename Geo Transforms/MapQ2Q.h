@@ -0,0 +1,63 @@
+/** Interface file for mapping a source quad on to a target quad
+ *
+ *  \file ipcv/geometric_transformation/MapQ2Q.h
+ *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
+ *  \edited: Andrea Avendano (aa6588@rit.edu)
+ *  \date 3 October
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "Warp.h"
+
+namespace ipcv {
+
+/** Find the homography of a quad to quad mapping
+ *
+ *  The homography only depends on the vertices, so a keystone correction
+ *  of video can find it once and give it to Warp for every frame.
+ *
+ *  \param[in] src_vertices
+ *                       vertices cv:Point of the source quadrilateral (CW)
+ *                       which is to be mapped to the target quadrilateral
+ *  \param[in] tgt_vertices
+ *                       vertices cv:Point of the target quadrilateral (CW)
+ *                       into which the source quadrilateral is to be mapped
+ *  \param[out] transform
+ *                       PROJECTIVE transformation from target (x, y) to the
+ *                       source coordinates map1, map2 hold
+ */
+bool Q2QTransform(const std::vector<cv::Point>& src_vertices,
+                  const std::vector<cv::Point>& tgt_vertices,
+                  Transform& transform);
+
+/** Find the source coordinates (map1, map2) for a quad to quad mapping
+ *
+ *  \param[in] src       source cv::Mat of CV_8UC3
+ *  \param[in] tgt       target cv::Mat of CV_8UC3
+ *  \param[in] src_vertices
+ *                       vertices cv:Point of the source quadrilateral (CW)
+ *                       which is to be mapped to the target quadrilateral
+ *  \param[in] tgt_vertices
+ *                       vertices cv:Point of the target quadrilateral (CW)
+ *                       into which the source quadrilateral is to be mapped
+ *  \param[out] map1     cv::Mat of CV_32FC1 (size of the destination map)
+ *                       containing the horizontal (x) coordinates at
+ *                       which to resample the source data
+ *  \param[out] map2     cv::Mat of CV_32FC1 (size of the destination map)
+ *                       containing the vertical (y) coordinates at
+ *                       which to resample the source data
+ *  \param[in] num_threads
+ *                       number of worker threads the rows are distributed
+ *                       over (if less than 1, use the number of hardware
+ *                       threads)
+ */
+bool MapQ2Q(const cv::Mat src, const cv::Mat tgt,
+            const std::vector<cv::Point> src_vertices,
+            std::vector<cv::Point> tgt_vertices, cv::Mat& map1, cv::Mat& map2,
+            const int num_threads = 0);
+}
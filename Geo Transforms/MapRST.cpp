@@ -8,14 +8,80 @@
 
 #include "MapRST.h"
 
+#include <cmath>
 #include <iostream>
 
 #include <eigen3/Eigen/Dense>
 
+#include "imgs/ipcv/utils/Parallel.h"
+
 using namespace std;
 
 namespace ipcv {
 
+/** Find the destination to source transformation of an RST transformation
+ *
+ *  \param[in] src_size      size of the source
+ *  \param[in] angle         rotation angle (CCW) [radians]
+ *  \param[in] scale_x       horizontal scale
+ *  \param[in] scale_y       vertical scale
+ *  \param[in] translation_x horizontal translation [+ right]
+ *  \param[in] translation_y vertical translation [+ up]
+ *  \param[out] map_size     size of the destination map
+ *  \param[out] transform    AFFINE transformation from destination (x, y) to
+ *                           the source coordinates map1, map2 hold
+ */
+bool RSTTransform(const cv::Size src_size, const double angle,
+                  const double scale_x, const double scale_y,
+                  const double translation_x, const double translation_y,
+                  cv::Size &map_size, Transform &transform) {
+
+  // Define function matrices
+  Eigen::Matrix3d scale;
+  Eigen::Matrix3d trans;
+  Eigen::Matrix3d rotate;
+  // Scaling function
+  scale << (1 / scale_x), 0, 0, 0, (1 / scale_y), 0, 0, 0, 1;
+  // Rotating function
+  rotate << cos(angle), sin(angle), 0, -sin(angle), cos(angle), 0, 0, 0, 1;
+  // Translation function
+  trans << 1, 0, translation_y, 0, 1, translation_x, 0, 0, 1;
+  // RST function, from (row, -col) about the centers
+  Eigen::Matrix3d rst = rotate * scale * trans;
+
+  // Make Map size
+  double a = src_size.width * abs(sin(angle));
+  double b = src_size.height * abs(cos(angle));
+  double c = src_size.width * abs(cos(angle));
+  double d = src_size.height * abs(sin(angle));
+  map_size.height = static_cast<int>(scale_x * floor(a + b));
+  map_size.width = static_cast<int>(scale_y * floor(c + d));
+
+  // The centers are taken in whole pixels, as map rows, cols and source
+  // rows, cols are halved in integers
+  double map_cy = map_size.height / 2;
+  double map_cx = map_size.width / 2;
+  double src_cy = src_size.height / 2;
+  double src_cx = src_size.width / 2;
+
+  // Shifting the origin to the map center, flipping columns, applying rst
+  // and shifting back to the source center folds into one affine matrix
+  // in (col, row)
+  transform.type = TransformType::AFFINE;
+  transform.order = 1;
+  transform.coefficients.create(2, 3, CV_64FC1);
+  double *ax = transform.coefficients.ptr<double>(0);
+  double *ay = transform.coefficients.ptr<double>(1);
+  ax[0] = rst(1, 1);
+  ax[1] = -rst(1, 0);
+  ax[2] = src_cx + rst(1, 0) * map_cy - rst(1, 1) * map_cx - rst(1, 2);
+  ay[0] = -rst(0, 1);
+  ay[1] = rst(0, 0);
+  ay[2] = src_cy - rst(0, 0) * map_cy + rst(0, 1) * map_cx + rst(0, 2);
+
+  return true;
+}
+
 /** Find the map coordinates (map1, map2) for an RST transformation
  *
  *  \param[in] src           source cv::Mat of CV_8UC3
@@ -30,59 +96,41 @@ namespace ipcv {
  *  \param[out] map2         cv::Mat of CV_32FC1 (size of the destination map)
  *                           containing the vertical (y) coordinates at
  *                           which to resample the source data
+ *  \param[in] num_threads   number of worker threads the rows are
+ *                           distributed over (if less than 1, use the
+ *                           number of hardware threads)
  */
 bool MapRST(const cv::Mat src, const double angle, const double scale_x,
             const double scale_y, const double translation_x,
-            const double translation_y, cv::Mat &map1, cv::Mat &map2) {
+            const double translation_y, cv::Mat &map1, cv::Mat &map2,
+            const int num_threads) {
+  cv::Size map_size;
+  Transform transform;
+  RSTTransform(src.size(), angle, scale_x, scale_y, translation_x,
+               translation_y, map_size, transform);
 
-  // Define function matrices
-  Eigen::MatrixXd scale(3, 3);
-  Eigen::MatrixXd trans(3, 3);
-  Eigen::MatrixXd rotate(3, 3);
-  Eigen::MatrixXd rst(3, 3);
-  // Scaling function
-  scale << (1 / scale_x), 0, 0, 0, (1 / scale_y), 0, 0, 0, 1;
-  // Rotating function
-  rotate << cos(angle), sin(angle), 0, -sin(angle), cos(angle), 0, 0, 0, 1;
-  // Translation function
-  trans << 1, 0, translation_y, 0, 1, translation_x, 0, 0, 1;
-  // RST function
-  rst = rotate * scale * trans;
-
-  // Make Map matrix
-
-  double a = src.cols * abs(sin(angle));
-  double b = src.rows * abs(cos(angle));
-  double c = src.cols * abs(cos(angle));
-  double d = src.rows * abs(sin(angle));
-  double map_rows = scale_x * floor(a + b);
-  double map_cols = scale_y * floor(c + d);  
-  
-  map1.create(map_rows, map_cols, CV_32FC1);
-  map2.create(map_rows, map_cols, CV_32FC1);
-
-  // Create frame coordinates
-  Eigen::MatrixXd xy(3, 1);
-  Eigen::MatrixXd xy_prime(3, 1);
-
-  // For entire image
-  for (int rows = 0; rows < map1.rows; rows++) {
-    for (int cols = 0; cols < map2.cols; cols++) {
-      // Shift origin
-      xy << rows - (map1.rows / 2),  (map1.cols / 2) - cols, 1;
-
-      // Apply transform
-      xy_prime = rst * xy;
-
-      // Shift origin back
-      xy_prime(0, 0) = xy_prime(0, 0) + src.rows / 2;
-      xy_prime(1, 0) = src.cols / 2 - xy_prime(1, 0);
-      
-      //Fill maps
-      map1.at<float>(rows, cols) = xy_prime(0, 0);
-      map2.at<float>(rows, cols) = xy_prime(1, 0);
-    }
-  }
+  map1.create(map_size, CV_32FC1);
+  map2.create(map_size, CV_32FC1);
+
+  // Both coordinates are linear along a row, so each row costs one multiply
+  // and add per coordinate and vectorizes
+  const double *ax = transform.coefficients.ptr<double>(0);
+  const double *ay = transform.coefficients.ptr<double>(1);
+  ParallelFor(
+      map_size.height, num_threads,
+      [&](int begin, int end) {
+        for (int r = begin; r < end; r++) {
+          double x0 = ax[1] * r + ax[2];
+          double y0 = ay[1] * r + ay[2];
+          float *map1_row = map1.ptr<float>(r);
+          float *map2_row = map2.ptr<float>(r);
+          for (int c = 0; c < map_size.width; c++) {
+            map1_row[c] = static_cast<float>(x0 + ax[0] * c);
+            map2_row[c] = static_cast<float>(y0 + ay[0] * c);
+          }
+        }
+      },
+      16);
 
   return true;
 }
@@ -0,0 +1,60 @@
+/** Interface file for finding map coordinates for an RST transformation
+ *
+ *  \file ipcv/geometric_transformation/MapRST.h
+ *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
+ *  \edited: Andrea Avendano (aa6588@rit.edu)
+ *  \date 26 Sept 2020
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include "Warp.h"
+
+namespace ipcv {
+
+/** Find the destination to source transformation of an RST transformation
+ *
+ *  The rotation, scaling and translation about the image centers compose
+ *  to one 2 x 3 affine matrix, which can be cached and given to Warp in
+ *  place of the maps MapRST would generate.
+ *
+ *  \param[in] src_size      size of the source
+ *  \param[in] angle         rotation angle (CCW) [radians]
+ *  \param[in] scale_x       horizontal scale
+ *  \param[in] scale_y       vertical scale
+ *  \param[in] translation_x horizontal translation [+ right]
+ *  \param[in] translation_y vertical translation [+ up]
+ *  \param[out] map_size     size of the destination map
+ *  \param[out] transform    AFFINE transformation from destination (x, y) to
+ *                           the source coordinates map1, map2 hold
+ */
+bool RSTTransform(const cv::Size src_size, const double angle,
+                  const double scale_x, const double scale_y,
+                  const double translation_x, const double translation_y,
+                  cv::Size& map_size, Transform& transform);
+
+/** Find the map coordinates (map1, map2) for an RST transformation
+ *
+ *  \param[in] src           source cv::Mat of CV_8UC3
+ *  \param[in] angle         rotation angle (CCW) [radians]
+ *  \param[in] scale_x       horizontal scale
+ *  \param[in] scale_y       vertical scale
+ *  \param[in] translation_x horizontal translation [+ right]
+ *  \param[in] translation_y vertical translation [+ up]
+ *  \param[out] map1         cv::Mat of CV_32FC1 (size of the destination map)
+ *                           containing the horizontal (x) coordinates at
+ *                           which to resample the source data
+ *  \param[out] map2         cv::Mat of CV_32FC1 (size of the destination map)
+ *                           containing the vertical (y) coordinates at
+ *                           which to resample the source data
+ *  \param[in] num_threads   number of worker threads the rows are
+ *                           distributed over (if less than 1, use the
+ *                           number of hardware threads)
+ */
+bool MapRST(const cv::Mat src, const double angle, const double scale_x,
+            const double scale_y, const double translation_x,
+            const double translation_y, cv::Mat& map1, cv::Mat& map2,
+            const int num_threads = 0);
+}
@@ -0,0 +1,394 @@
+/** Implementation file for fitting ground control point transformations
+ *  robustly to outliers
+ *
+ *  \file ipcv/geometric_transformation/RansacGCP.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "MapGCP.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <eigen3/Eigen/Dense>
+
+#include "imgs/ipcv/utils/Parallel.h"
+
+using namespace std;
+
+namespace ipcv {
+
+// Rounds of local optimization applied to a new best hypothesis
+static const int kLocalIterations = 4;
+
+// Hypotheses drawn between checks of the adaptive stopping criterion
+static const int kRoundSize = 256;
+
+/** Source coordinates a transformation maps a map point to
+ *
+ *  \param[in] transform  transformation with CV_64F coefficients
+ *  \param[in] x          horizontal map coordinate
+ *  \param[in] y          vertical map coordinate
+ *  \param[out] sx        horizontal source coordinate
+ *  \param[out] sy        vertical source coordinate
+ */
+static void MapPoint(const Transform &transform, const double x,
+                     const double y, double &sx, double &sy) {
+  const cv::Mat &a = transform.coefficients;
+  switch (transform.type) {
+  case TransformType::AFFINE:
+    sx = a.at<double>(0, 0) * x + a.at<double>(0, 1) * y + a.at<double>(0, 2);
+    sy = a.at<double>(1, 0) * x + a.at<double>(1, 1) * y + a.at<double>(1, 2);
+    break;
+  case TransformType::PROJECTIVE: {
+    double w =
+        a.at<double>(2, 0) * x + a.at<double>(2, 1) * y + a.at<double>(2, 2);
+    sx = (a.at<double>(0, 0) * x + a.at<double>(0, 1) * y +
+          a.at<double>(0, 2)) /
+         w;
+    sy = (a.at<double>(1, 0) * x + a.at<double>(1, 1) * y +
+          a.at<double>(1, 2)) /
+         w;
+    break;
+  }
+  case TransformType::POLYNOMIAL: {
+    const double *ax = a.ptr<double>(0);
+    const double *ay = a.ptr<double>(1);
+    sx = 0;
+    sy = 0;
+    int term = 0;
+    double y_power = 1;
+    for (int j = 0; j <= transform.order; j++) {
+      double power = y_power;
+      for (int i = 0; i <= transform.order - j; i++, term++) {
+        sx += ax[term] * power;
+        sy += ay[term] * power;
+        power *= x;
+      }
+      y_power *= y;
+    }
+    break;
+  }
+  }
+}
+
+/** Similarity moving the centroid of points to the origin and their mean
+ *  distance from it to sqrt(2), which conditions the homography solve
+ */
+static Eigen::Matrix3d Normalization(const vector<cv::Point> &points,
+                                     const vector<int> &subset) {
+  double cx = 0;
+  double cy = 0;
+  for (int idx : subset) {
+    cx += points[idx].x;
+    cy += points[idx].y;
+  }
+  cx /= subset.size();
+  cy /= subset.size();
+  double distance = 0;
+  for (int idx : subset) {
+    distance += hypot(points[idx].x - cx, points[idx].y - cy);
+  }
+  distance /= subset.size();
+  double s = distance > 0 ? sqrt(2.0) / distance : 1;
+
+  Eigen::Matrix3d t;
+  t << s, 0, -s * cx, 0, s, -s * cy, 0, 0, 1;
+  return t;
+}
+
+/** Homography from map to source points by the normalized direct linear
+ *  transformation
+ */
+static bool FitHomography(const vector<cv::Point> &src_points,
+                          const vector<cv::Point> &map_points,
+                          const vector<int> &subset, Transform &transform) {
+  Eigen::Matrix3d t_src = Normalization(src_points, subset);
+  Eigen::Matrix3d t_map = Normalization(map_points, subset);
+  int n = static_cast<int>(subset.size());
+  Eigen::MatrixXd a(2 * n, 9);
+  for (int k = 0; k < n; k++) {
+    Eigen::Vector3d p = t_map * Eigen::Vector3d(map_points[subset[k]].x,
+                                                map_points[subset[k]].y, 1);
+    Eigen::Vector3d q = t_src * Eigen::Vector3d(src_points[subset[k]].x,
+                                                src_points[subset[k]].y, 1);
+    a.row(2 * k) << p(0), p(1), 1, 0, 0, 0, -q(0) * p(0), -q(0) * p(1), -q(0);
+    a.row(2 * k + 1) << 0, 0, 0, p(0), p(1), 1, -q(1) * p(0), -q(1) * p(1),
+        -q(1);
+  }
+
+  // The homography is the right singular vector of the smallest singular
+  // value (computing the full V is required for fewer rows than columns)
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(a, Eigen::ComputeFullV);
+  Eigen::VectorXd h = svd.matrixV().col(8);
+  Eigen::Matrix3d normalized;
+  normalized << h(0), h(1), h(2), h(3), h(4), h(5), h(6), h(7), h(8);
+  Eigen::Matrix3d homography = t_src.inverse() * normalized * t_map;
+  if (!homography.allFinite() || homography(2, 2) == 0) {
+    return false;
+  }
+  homography /= homography(2, 2);
+
+  transform.type = TransformType::PROJECTIVE;
+  transform.order = 1;
+  transform.coefficients.create(3, 3, CV_64FC1);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      transform.coefficients.at<double>(i, j) = homography(i, j);
+    }
+  }
+  return true;
+}
+
+/** Fits a transformation to a subset of the ground control points
+ *
+ *  \return  false if the subset is degenerate
+ */
+static bool FitSubset(const vector<cv::Point> &src_points,
+                      const vector<cv::Point> &map_points,
+                      const TransformType type, const int order,
+                      const vector<int> &subset, Transform &transform) {
+  if (type == TransformType::PROJECTIVE) {
+    return FitHomography(src_points, map_points, subset, transform);
+  }
+
+  vector<cv::Point> src_subset;
+  vector<cv::Point> map_subset;
+  for (int idx : subset) {
+    src_subset.push_back(src_points[idx]);
+    map_subset.push_back(map_points[idx]);
+  }
+  vector<double> residuals;
+  double rms;
+  Transform polynomial;
+  if (!GCPTransform(src_subset, map_subset,
+                    type == TransformType::AFFINE ? 1 : order, polynomial,
+                    residuals, rms)) {
+    return false;
+  }
+  if (type == TransformType::POLYNOMIAL) {
+    transform = polynomial;
+    return true;
+  }
+
+  // First order terms are 1, x, y; the affine matrix multiplies (x, y, 1)
+  transform.type = TransformType::AFFINE;
+  transform.order = 1;
+  transform.coefficients.create(2, 3, CV_64FC1);
+  for (int row = 0; row < 2; row++) {
+    const double *terms = polynomial.coefficients.ptr<double>(row);
+    double *a = transform.coefficients.ptr<double>(row);
+    a[0] = terms[1];
+    a[1] = terms[2];
+    a[2] = terms[0];
+  }
+  return true;
+}
+
+/** Inliers of a transformation and their truncated squared error
+ *
+ *  \return  number of inliers
+ */
+static int ScoreTransform(const vector<cv::Point> &src_points,
+                          const vector<cv::Point> &map_points,
+                          const Transform &transform, const double threshold,
+                          double &cost, vector<uint8_t> *inliers) {
+  int count = 0;
+  double limit = threshold * threshold;
+  cost = 0;
+  for (size_t idx = 0; idx < src_points.size(); idx++) {
+    double sx;
+    double sy;
+    MapPoint(transform, map_points[idx].x, map_points[idx].y, sx, sy);
+    double dx = sx - src_points[idx].x;
+    double dy = sy - src_points[idx].y;
+    double error = dx * dx + dy * dy;
+    bool inlier = error < limit;
+    count += inlier;
+    cost += inlier ? error : limit;
+    if (inliers != nullptr) {
+      (*inliers)[idx] = inlier;
+    }
+  }
+  return count;
+}
+
+/** Whether a hypothesis is better: more inliers, then a lower cost */
+static bool Better(const int count, const double cost, const int best_count,
+                   const double best_cost) {
+  return count > best_count || (count == best_count && cost < best_cost);
+}
+
+/** Fit a transformation to ground control points with RANSAC, refining
+ *  each new best hypothesis on its inliers (LO-RANSAC)
+ *
+ *  \param[in] src_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the source image
+ *  \param[in] map_points
+ *                   vector of cv::Points representing the ground control
+ *                   points from the map image
+ *  \param[in] type  AFFINE, PROJECTIVE or POLYNOMIAL
+ *  \param[in] order  mapping polynomial order (1, 2 or 3, POLYNOMIAL only)
+ *  \param[in] threshold
+ *                    largest distance between a source point and its
+ *                    mapped map point for an inlier [pixels]
+ *  \param[out] transform
+ *                    transformation from map (x, y) to the source
+ *                    coordinates map1, map2 hold, fitted to the inliers
+ *  \param[out] inliers
+ *                    mask of the inlying ground control points, which the
+ *                    result is fitted to (1 inlier, 0 outlier)
+ *  \param[in] confidence
+ *                    probability of drawing at least one outlier free
+ *                    sample before stopping
+ *  \param[in] max_iterations
+ *                    largest number of hypotheses drawn
+ *  \param[in] num_threads
+ *                    number of worker threads the hypotheses are evaluated
+ *                    on (if less than 1, use the number of hardware threads)
+ *  \param[in] seed   seed of the random samples
+ */
+bool RansacGCPTransform(const vector<cv::Point> &src_points,
+                        const vector<cv::Point> &map_points,
+                        const TransformType type, const int order,
+                        const double threshold, Transform &transform,
+                        vector<uint8_t> &inliers, const double confidence,
+                        const int max_iterations, const int num_threads,
+                        const unsigned seed) {
+  int num_points = static_cast<int>(src_points.size());
+  int sample_size = type == TransformType::AFFINE       ? 3
+                    : type == TransformType::PROJECTIVE ? 4
+                                                        : (order + 1) *
+                                                              (order + 2) / 2;
+  if (type == TransformType::POLYNOMIAL && (order < 1 || order > 3)) {
+    cerr << "*** ERROR *** ";
+    cerr << "RansacGCPTransform supports polynomial orders 1, 2 and 3"
+         << endl;
+    return false;
+  }
+  if (static_cast<int>(map_points.size()) != num_points ||
+      num_points < sample_size) {
+    cerr << "*** ERROR *** ";
+    cerr << "RansacGCPTransform needs as many source as map points, and at "
+            "least "
+         << sample_size << " of them" << endl;
+    return false;
+  }
+
+  // Hypotheses are drawn in rounds of a fixed size spread over the workers,
+  // each with its own generator seeded by the hypothesis number, so no
+  // generator is shared and the result does not depend on the number of
+  // threads
+  int best_count = 0;
+  double best_cost = 0;
+  Transform best;
+  int required = max_iterations;
+  int drawn = 0;
+  while (drawn < min(required, max_iterations)) {
+    int round = min(kRoundSize, min(required, max_iterations) - drawn);
+    vector<Transform> hypotheses(round);
+    vector<int> counts(round, -1);
+    vector<double> costs(round);
+    ParallelFor(round, num_threads, [&](int begin, int end) {
+      vector<int> subset(sample_size);
+      for (int h = begin; h < end; h++) {
+        // Consecutive seeds of a linear congruential generator give nearly
+        // equal first draws, so the seed and hypothesis number are mixed
+        seed_seq mixed{seed, static_cast<unsigned>(drawn + h)};
+        mt19937 rng(mixed);
+        uniform_int_distribution<int> pick(0, num_points - 1);
+        for (int k = 0; k < sample_size; k++) {
+          do {
+            subset[k] = pick(rng);
+          } while (find(subset.begin(), subset.begin() + k, subset[k]) !=
+                   subset.begin() + k);
+        }
+        if (FitSubset(src_points, map_points, type, order, subset,
+                      hypotheses[h])) {
+          counts[h] = ScoreTransform(src_points, map_points, hypotheses[h],
+                                     threshold, costs[h], nullptr);
+        }
+      }
+    });
+    drawn += round;
+
+    for (int h = 0; h < round; h++) {
+      if (counts[h] < sample_size ||
+          !Better(counts[h], costs[h], best_count, best_cost)) {
+        continue;
+      }
+      best = hypotheses[h];
+      best_count = counts[h];
+      best_cost = costs[h];
+
+      // Local optimization: refit to the inliers while that gains some
+      vector<uint8_t> mask(num_points);
+      for (int it = 0; it < kLocalIterations; it++) {
+        ScoreTransform(src_points, map_points, best, threshold, best_cost,
+                       &mask);
+        vector<int> subset;
+        for (int idx = 0; idx < num_points; idx++) {
+          if (mask[idx]) {
+            subset.push_back(idx);
+          }
+        }
+        Transform refined;
+        double cost;
+        if (static_cast<int>(subset.size()) < sample_size ||
+            !FitSubset(src_points, map_points, type, order, subset,
+                       refined)) {
+          break;
+        }
+        int count = ScoreTransform(src_points, map_points, refined,
+                                   threshold, cost, nullptr);
+        if (!Better(count, cost, best_count, best_cost)) {
+          break;
+        }
+        best = refined;
+        best_count = count;
+        best_cost = cost;
+      }
+
+      // Adaptive stopping on the inlier ratio of the best hypothesis
+      double ratio = static_cast<double>(best_count) / num_points;
+      double outlier_free = pow(ratio, sample_size);
+      if (outlier_free >= 1) {
+        required = 0;
+      } else if (outlier_free > 0) {
+        required = static_cast<int>(
+            min(static_cast<double>(max_iterations),
+                ceil(log(1 - confidence) / log(1 - outlier_free))));
+      }
+    }
+  }
+
+  if (best_count < sample_size) {
+    cerr << "*** ERROR *** ";
+    cerr << "RansacGCPTransform found no hypothesis with enough inliers"
+         << endl;
+    return false;
+  }
+
+  // The local optimization stops at a refit that gains nothing, so the best
+  // hypothesis may still be a minimal sample fit; the result is refitted to
+  // all of its inliers by least squares
+  inliers.assign(num_points, 0);
+  double cost;
+  ScoreTransform(src_points, map_points, best, threshold, cost, &inliers);
+  vector<int> subset;
+  for (int idx = 0; idx < num_points; idx++) {
+    if (inliers[idx]) {
+      subset.push_back(idx);
+    }
+  }
+  if (!FitSubset(src_points, map_points, type, order, subset, transform)) {
+    transform = best;
+  }
+  return true;
+}
+} // namespace ipcv
@@ -8,16 +8,388 @@
 
 #include "Remap.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
 #include <iostream>
+#include <vector>
+
+#include "RemapRows.h"
+#include "imgs/ipcv/utils/Parallel.h"
 
 using namespace std;
 
 namespace ipcv {
 
+/** Weights of the 1D interpolation kernel at a fractional offset
+ *
+ *  \param[in] interpolation  interpolation method
+ *  \param[in] t              fractional offset in [0, 1)
+ *  \param[out] k             ksize weights
+ */
+static void KernelWeights(const Interpolation interpolation, const float t,
+                          float *k) {
+  switch (interpolation) {
+  case Interpolation::LINEAR:
+    k[0] = 1 - t;
+    k[1] = t;
+    break;
+  case Interpolation::CUBIC: {
+    // Keys cubic convolution with a = -0.75, as in OpenCV
+    const float a = -0.75f;
+    float t1 = t + 1;
+    float u = 1 - t;
+    k[0] = ((a * t1 - 5 * a) * t1 + 8 * a) * t1 - 4 * a;
+    k[1] = ((a + 2) * t - (a + 3)) * t * t + 1;
+    k[2] = ((a + 2) * u - (a + 3)) * u * u + 1;
+    k[3] = 1 - k[0] - k[1] - k[2];
+    break;
+  }
+  case Interpolation::LANCZOS4: {
+    // sinc(d) sinc(d / 4) at the distances d of the 8 taps, normalized
+    float sum = 0;
+    for (int i = 0; i < 8; i++) {
+      double d = t + 3 - i;
+      if (fabs(d) < 1e-6) {
+        k[i] = 1;
+      } else {
+        double angle = M_PI * d;
+        k[i] = static_cast<float>(4 * sin(angle) * sin(angle / 4) /
+                                  (angle * angle));
+      }
+      sum += k[i];
+    }
+    for (int i = 0; i < 8; i++) {
+      k[i] /= sum;
+    }
+    break;
+  }
+  default:
+    k[0] = 1;
+  }
+}
+
+/** Builds the weight table of an interpolation method
+ *
+ *  \param[in] interpolation  interpolation method
+ *  \param[in] ksize          size of the 1D kernel
+ */
+static RemapWeights BuildWeights(const Interpolation interpolation,
+                                 const int ksize) {
+  RemapWeights table;
+  table.ksize = ksize;
+  int num_taps = ksize * ksize;
+  int entries = kRemapTableSize * kRemapTableSize;
+  table.weights.resize(entries * num_taps);
+  table.fixed.resize(entries * num_taps);
+
+  vector<float> kx(ksize);
+  vector<float> ky(ksize);
+  for (int fy = 0; fy < kRemapTableSize; fy++) {
+    KernelWeights(interpolation, static_cast<float>(fy) / kRemapTableSize,
+                  ky.data());
+    for (int fx = 0; fx < kRemapTableSize; fx++) {
+      KernelWeights(interpolation, static_cast<float>(fx) / kRemapTableSize,
+                    kx.data());
+      int entry = (fy * kRemapTableSize + fx) * num_taps;
+      float *weights = &table.weights[entry];
+      int32_t *fixed = &table.fixed[entry];
+      int32_t sum = 0;
+      for (int k = 0; k < num_taps; k++) {
+        weights[k] = ky[k / ksize] * kx[k % ksize];
+        fixed[k] = static_cast<int32_t>(
+            lrint(weights[k] * (1 << kRemapWeightBits)));
+        sum += fixed[k];
+      }
+
+      // Rounding the fixed point weights one at a time loses up to half a
+      // unit each; a tap of the same 2 x 2 block OpenCV adjusts absorbs the
+      // difference, so a constant image stays exactly constant and 8-bit
+      // results agree with cv::remap
+      int first = min(ksize / 2, ksize - 2);
+      int smallest = first * ksize + first;
+      int largest = smallest;
+      for (int cy = first; cy < first + 2; cy++) {
+        for (int cx = first; cx < first + 2; cx++) {
+          int k = cy * ksize + cx;
+          if (fixed[k] < fixed[smallest]) {
+            smallest = k;
+          } else if (fixed[k] > fixed[largest]) {
+            largest = k;
+          }
+        }
+      }
+      int32_t excess = sum - (1 << kRemapWeightBits);
+      fixed[excess < 0 ? largest : smallest] -= excess;
+    }
+  }
+  return table;
+}
+
+/** Interpolation weights for an interpolation method, computed on first use
+ *
+ *  \param[in] interpolation  interpolation method (not NEAREST)
+ *
+ *  \return                   weight table
+ */
+const RemapWeights &InterpolationWeights(const Interpolation interpolation) {
+  static const RemapWeights linear = BuildWeights(Interpolation::LINEAR, 2);
+  static const RemapWeights cubic = BuildWeights(Interpolation::CUBIC, 4);
+  static const RemapWeights lanczos =
+      BuildWeights(Interpolation::LANCZOS4, 8);
+  switch (interpolation) {
+  case Interpolation::CUBIC:
+    return cubic;
+  case Interpolation::LANCZOS4:
+    return lanczos;
+  default:
+    return linear;
+  }
+}
+
+/** Converts n coordinates of type C to fixed point
+ *
+ *  \param[in] map_x      horizontal source coordinates
+ *  \param[in] map_y      vertical source coordinates
+ *  \param[in] n          number of coordinates
+ *  \param[in] nearest    whether to round to the nearest pixel instead of
+ *                        quantizing the fractional part
+ *  \param[out] xy        n (x, y) pairs of integer coordinates
+ *  \param[out] fraction  n fractional parts (not written if nearest)
+ */
+template <typename C>
+static void QuantizeRow(const C *map_x, const C *map_y, const int n,
+                        const bool nearest, int16_t *xy, uint16_t *fraction) {
+  // Coordinates are rounded half to even like cv::remap and saturated to
+  // the int16 range, which is still outside of any supported source; NaNs
+  // land on the lower bound
+  int scale = nearest ? 1 : kRemapTableSize;
+  double lower = static_cast<double>(SHRT_MIN) * scale;
+  double upper = (static_cast<double>(SHRT_MAX) + 1) * scale - 1;
+  auto quantize = [&](const C coordinate) {
+    double q = nearbyint(static_cast<double>(coordinate) * scale);
+    return static_cast<int>(q >= lower ? min(q, upper) : lower);
+  };
+
+  for (int i = 0; i < n; i++) {
+    int qx = quantize(map_x[i]);
+    int qy = quantize(map_y[i]);
+    if (nearest) {
+      xy[2 * i] = static_cast<int16_t>(qx);
+      xy[2 * i + 1] = static_cast<int16_t>(qy);
+    } else {
+      xy[2 * i] = static_cast<int16_t>(qx >> kRemapBits);
+      xy[2 * i + 1] = static_cast<int16_t>(qy >> kRemapBits);
+      fraction[i] = static_cast<uint16_t>(
+          (qy & (kRemapTableSize - 1)) * kRemapTableSize +
+          (qx & (kRemapTableSize - 1)));
+    }
+  }
+}
+
+/** Converts n map coordinates to fixed point
+ *
+ *  \param[in] map_x      horizontal source coordinates
+ *  \param[in] map_y      vertical source coordinates
+ *  \param[in] n          number of coordinates
+ *  \param[in] nearest    whether to round to the nearest pixel instead of
+ *                        quantizing the fractional part
+ *  \param[out] xy        n (x, y) pairs of integer coordinates
+ *  \param[out] fraction  n fractional parts (not written if nearest)
+ */
+void ConvertMapRow(const float *map_x, const float *map_y, const int n,
+                   const bool nearest, int16_t *xy, uint16_t *fraction) {
+  QuantizeRow(map_x, map_y, n, nearest, xy, fraction);
+}
+
+/** Converts n double precision coordinates to fixed point */
+void ConvertMapRow(const double *map_x, const double *map_y, const int n,
+                   const bool nearest, int16_t *xy, uint16_t *fraction) {
+  QuantizeRow(map_x, map_y, n, nearest, xy, fraction);
+}
+
+// Spacing of the samples along tile edges that bound the source footprint
+// of a tile, and side of the source cells tiles are ordered by [pixels]
+static const int kFootprintStep = 16;
+
+/** Interleaves the bits of two cell indices, giving their position along a
+ *  Z-order curve
+ */
+static uint32_t MortonCode(const int x, const int y) {
+  auto spread = [](uint32_t v) {
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+  };
+  return spread(x) | (spread(y) << 1);
+}
+
+/** Bounding box of the source coordinates along the edges of a destination
+ *  tile
+ *
+ *  The maps of geometric transformations are smooth, so the coordinates
+ *  inside a tile lie within those on its edges, and samples along the edges
+ *  bound the source region the whole tile reads at a fraction of the cost
+ *  of reading the tile of the maps.
+ *
+ *  \param[in] tile       destination tile
+ *  \param[in] source_at  callable setting the source coordinates (x, y) of
+ *                        the destination pixel (row, col), returning false
+ *                        if they are not defined (NaN)
+ *
+ *  \return               bounding box of the integer parts of the
+ *                        coordinates, empty if none is defined
+ */
+template <typename SourceAt>
+static cv::Rect EdgeBounds(const cv::Rect &tile, SourceAt source_at) {
+  double min_x = DBL_MAX;
+  double max_x = -DBL_MAX;
+  double min_y = DBL_MAX;
+  double max_y = -DBL_MAX;
+  auto sample = [&](const int row, const int col) {
+    double x;
+    double y;
+    if (source_at(row, col, x, y)) {
+      min_x = min(min_x, x);
+      max_x = max(max_x, x);
+      min_y = min(min_y, y);
+      max_y = max(max_y, y);
+    }
+  };
+  int last_row = tile.y + tile.height - 1;
+  int last_col = tile.x + tile.width - 1;
+  for (int c = tile.x;; c = min(c + kFootprintStep, last_col)) {
+    sample(tile.y, c);
+    sample(last_row, c);
+    if (c == last_col) {
+      break;
+    }
+  }
+  for (int r = tile.y;; r = min(r + kFootprintStep, last_row)) {
+    sample(r, tile.x);
+    sample(r, last_col);
+    if (r == last_row) {
+      break;
+    }
+  }
+  if (min_x > max_x || min_y > max_y) {
+    return cv::Rect();
+  }
+
+  // Coordinates saturate to 16 bits
+  int x0 = static_cast<int>(max(floor(min_x), -32768.0));
+  int y0 = static_cast<int>(max(floor(min_y), -32768.0));
+  int x1 = static_cast<int>(min(floor(max_x), 32767.0));
+  int y1 = static_cast<int>(min(floor(max_y), 32767.0));
+  return cv::Rect(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+/** Split the destination into tiles and order them by the source region
+ *  they read
+ *
+ *  Consecutive pixels of a rotated destination row walk the source
+ *  diagonally, so in destination order the source lines one tile reads are
+ *  evicted before the neighboring tiles read them again.  Visiting tiles
+ *  along a Z-order curve over the centers of their source footprints keeps
+ *  the overlap of adjacent footprints in cache, whatever the rotation.
+ *
+ *  \param[in] src          source cv::Mat
+ *  \param[in] size         destination size
+ *  \param[in] num_threads  number of worker threads
+ *  \param[in] source_at    callable setting the source coordinates (x, y) of
+ *                          the destination pixel (row, col), returning false
+ *                          if they are not defined (NaN)
+ *
+ *  \return                 destination tiles in processing order
+ */
+template <typename SourceAt>
+static vector<cv::Rect> ScheduleTiles(const cv::Mat &src, const cv::Size size,
+                                      const int num_threads,
+                                      SourceAt source_at) {
+  int tiles_x = (size.width + kRemapTileCols - 1) / kRemapTileCols;
+  int tiles_y = (size.height + kRemapTileRows - 1) / kRemapTileRows;
+  int num_tiles = tiles_x * tiles_y;
+  vector<cv::Rect> tiles(num_tiles);
+  vector<uint32_t> keys(num_tiles);
+  ParallelFor(num_tiles, num_threads, [&](int begin, int end) {
+    for (int idx = begin; idx < end; idx++) {
+      int col = (idx % tiles_x) * kRemapTileCols;
+      int row = (idx / tiles_x) * kRemapTileRows;
+      tiles[idx] = cv::Rect(col, row, min(kRemapTileCols, size.width - col),
+                            min(kRemapTileRows, size.height - row));
+
+      // Centers are clamped to the source, and tiles reading nothing sort
+      // first
+      cv::Rect box = EdgeBounds(tiles[idx], source_at);
+      int cx = min(max(box.x + box.width / 2, 0), src.cols - 1);
+      int cy = min(max(box.y + box.height / 2, 0), src.rows - 1);
+      keys[idx] = MortonCode(cx / kFootprintStep, cy / kFootprintStep);
+    }
+  });
+
+  vector<int> order(num_tiles);
+  for (int idx = 0; idx < num_tiles; idx++) {
+    order[idx] = idx;
+  }
+  stable_sort(order.begin(), order.end(),
+              [&](int a, int b) { return keys[a] < keys[b]; });
+  vector<cv::Rect> scheduled(num_tiles);
+  for (int idx = 0; idx < num_tiles; idx++) {
+    scheduled[idx] = tiles[order[idx]];
+  }
+  return scheduled;
+}
+
+/** Remap source values of type T, one tile at a time over a pool of threads
+ *
+ *  \param[in] src            source cv::Mat
+ *  \param[out] dst           destination cv::Mat, already allocated
+ *  \param[in] tiles          destination tiles in processing order
+ *  \param[in] interpolation  interpolation method
+ *  \param[in] border_mode    pixel extrapolation method
+ *  \param[in] border_value   value to use for constant border mode
+ *  \param[in] num_threads    number of worker threads
+ *  \param[in] coordinates    callable setting the fixed point coordinates
+ *                            and fractions of n destination pixels from
+ *                            (row, col), either by filling the scratch
+ *                            buffers it is given or by pointing elsewhere
+ */
+template <typename T, typename Coordinates>
+static void RemapTiles(const cv::Mat &src, cv::Mat &dst,
+                       const vector<cv::Rect> &tiles,
+                       const Interpolation interpolation,
+                       const BorderMode border_mode, const uint8_t border_value,
+                       const int num_threads, Coordinates coordinates) {
+  vector<T> border_pixel(src.channels(), cv::saturate_cast<T>(border_value));
+  int num_tiles = static_cast<int>(tiles.size());
+  ParallelFor(num_tiles, num_threads, [&](int begin, int end) {
+    vector<int16_t> xy(2 * kRemapTileCols);
+    vector<uint16_t> fraction(kRemapTileCols);
+    for (int idx = begin; idx < end; idx++) {
+      const cv::Rect &tile = tiles[idx];
+      for (int r = tile.y; r < tile.y + tile.height; r++) {
+        const int16_t *xy_row = xy.data();
+        const uint16_t *fraction_row = fraction.data();
+        coordinates(r, tile.x, tile.width, xy.data(), fraction.data(), xy_row,
+                    fraction_row);
+        RemapRow<T>(src, xy_row, fraction_row, tile.width, interpolation,
+                    border_mode, border_pixel.data(),
+                    dst.ptr<T>(r) + tile.x * src.channels());
+      }
+    }
+  });
+}
+
 /** Remap source values to the destination array at map1, map2 locations
  *
- *  \param[in] src            source cv::Mat of CV_8UC3
- *  \param[out] dst           destination cv::Mat of CV_8UC3 for remapped values
+ *  \param[in] src            source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                            or CV_64F with any number of channels
+ *  \param[out] dst           destination cv::Mat of the src type for remapped
+ *                            values
  *  \param[in] map1           cv::Mat of CV_32FC1 (size of the destination map)
  *                            containing the horizontal (x) coordinates at
  *                            which to resample the source data
@@ -28,87 +400,390 @@ namespace ipcv {
  *  \param[in] border_mode    border mode to be used for out of bounds pixels
  *  \param[in] border_value   border value to be used when constant border mode
  *                            is to be used
+ *  \param[in] num_threads    number of worker threads the tiles are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
  */
 bool Remap(const cv::Mat &src, cv::Mat &dst, const cv::Mat &map1,
            const cv::Mat &map2, const Interpolation interpolation,
-           const BorderMode border_mode, const uint8_t border_value) {
-  dst.create(map1.size(), src.type());
-
-  float x_prime;
-  float y_prime;
-
-  // Nearest Neighbor Interpolation
-  if (interpolation == ipcv::Interpolation::NEAREST) {
-    for (int rows = 0; rows < map1.rows; rows++) {
-      for (int cols = 0; cols < map2.cols; cols++) {
-        x_prime = floor(map1.at<float>(rows, cols) + 0.5);
-        y_prime = floor(map2.at<float>(rows, cols) + 0.5);
-
-        // Replicate pixels in border
-        if (border_mode == ipcv::BorderMode::REPLICATE) {
-          dst.at<cv::Vec3b>(rows, cols) =
-              // clamp pixel values to src pixel value range
-              src.at<cv::Vec3b>(clamp(x_prime, static_cast<float>(0),
-                                      static_cast<float>(src.rows-1)),
-                                clamp(y_prime, static_cast<float>(0),
-                                      static_cast<float>(src.cols-1)));
-          // constant color border
-        } else if (border_mode == ipcv::BorderMode::CONSTANT) {
-          if (x_prime < 0 || x_prime >= src.rows || y_prime < 0 ||
-              y_prime >=
-                  src.cols) { // for pixels that fall outside the src border
-            dst.at<cv::Vec3b>(rows, cols) = border_value;
-          } else {
-            dst.at<cv::Vec3b>(rows, cols) = src.at<cv::Vec3b>(x_prime, y_prime);
-          }
-        }
-      }
-    }
+           const BorderMode border_mode, const uint8_t border_value,
+           const int num_threads) {
+  if (map1.type() != CV_32FC1 || map2.type() != CV_32FC1 ||
+      map1.size() != map2.size()) {
+    cerr << "*** ERROR *** ";
+    cerr << "Remap needs map1 and map2 of CV_32FC1 and the same size" << endl;
+    return false;
   }
+  cv::Mat converted = ResampleTarget(src, dst, map1.size(), src.type());
 
-  // Bilinear Interpolation
-  if (interpolation == ipcv::Interpolation::LINEAR) {
+  // Each tile row of the maps is converted to fixed point just before it is
+  // used, so the floating point maps share the resampling of converted maps
+  bool nearest = interpolation == Interpolation::NEAREST;
+  vector<cv::Rect> tiles = ScheduleTiles(
+      src, map1.size(), num_threads,
+      [&](const int r, const int c, double &x, double &y) {
+        x = map1.at<float>(r, c);
+        y = map2.at<float>(r, c);
+        return !isnan(x) && !isnan(y);
+      });
+  auto coordinates = [&](const int r, const int col, const int n,
+                         int16_t *xy, uint16_t *fraction,
+                         const int16_t *&, const uint16_t *&) {
+    ConvertMapRow(map1.ptr<float>(r) + col, map2.ptr<float>(r) + col, n,
+                  nearest, xy, fraction);
+  };
+  bool supported = WithSampleType(src.depth(), [&](auto sample) {
+    RemapTiles<decltype(sample)>(src, converted, tiles, interpolation,
+                                 border_mode, border_value, num_threads,
+                                 coordinates);
+  });
+  if (!supported) {
+    cerr << "*** ERROR *** ";
+    cerr << "Remap supports CV_8U, CV_16U, CV_16S, CV_32F and CV_64F sources"
+         << endl;
+    return false;
+  }
 
-    for (int x = 0; x < src.rows; x++) {
-      for (int y = 0; y < src.cols; y++) {
-        auto DC_x_y = src.at<cv::Vec3b>(x, y);
-        auto DC_x_y_1 = src.at<cv::Vec3b>(x, y + 1);
-        auto DC_x_1_y = src.at<cv::Vec3b>(x + 1, y);
-        auto DC_x_1_y_1 = src.at<cv::Vec3b>(x + 1, y + 1);
+  // A new image, if dst was src, replaces it only once resampling is done
+  dst = converted;
+  return true;
+}
 
-        for (int chan = 0; chan < 3; chan++) {
-          float DC_y =
-              (DC_x_1_y[chan] - DC_x_y[chan]) * (x_prime - x) + DC_x_y[chan];
-          float DC_y_1 = (DC_x_1_y_1[chan] - DC_x_y_1[chan]) * (x_prime - x) +
-                         DC_x_y_1[chan];
+/** Remap source values to the destination array at the locations of a map
+ *  converted to fixed point
+ *
+ *  \param[in] src            source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                            or CV_64F with any number of channels
+ *  \param[out] dst           destination cv::Mat of the src type for remapped
+ *                            values
+ *  \param[in] map            map converted by ConvertMaps, which also selects
+ *                            the interpolation
+ *  \param[in] border_mode    border mode to be used for out of bounds pixels
+ *  \param[in] border_value   border value to be used when constant border mode
+ *                            is to be used
+ *  \param[in] num_threads    number of worker threads the tiles are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
+ */
+bool Remap(const cv::Mat &src, cv::Mat &dst, const FixedPointMap &map,
+           const BorderMode border_mode, const uint8_t border_value,
+           const int num_threads) {
+  bool nearest = map.interpolation == Interpolation::NEAREST;
+  if (map.xy.type() != CV_16SC2 ||
+      (!nearest && (map.fraction.type() != CV_16UC1 ||
+                    map.fraction.size() != map.xy.size()))) {
+    cerr << "*** ERROR *** ";
+    cerr << "Remap needs a map converted by ConvertMaps" << endl;
+    return false;
+  }
+  cv::Mat converted = ResampleTarget(src, dst, map.xy.size(), src.type());
+
+  // The converted map is read in place
+  vector<cv::Rect> tiles = ScheduleTiles(
+      src, map.xy.size(), num_threads,
+      [&](const int r, const int c, double &x, double &y) {
+        const int16_t *p = map.xy.ptr<int16_t>(r) + 2 * c;
+        x = p[0];
+        y = p[1];
+        return true;
+      });
+  auto coordinates = [&](const int r, const int col, const int, int16_t *,
+                         uint16_t *, const int16_t *&xy_row,
+                         const uint16_t *&fraction_row) {
+    xy_row = map.xy.ptr<int16_t>(r) + 2 * col;
+    fraction_row = nearest ? nullptr : map.fraction.ptr<uint16_t>(r) + col;
+  };
+  bool supported = WithSampleType(src.depth(), [&](auto sample) {
+    RemapTiles<decltype(sample)>(src, converted, tiles, map.interpolation,
+                                 border_mode, border_value, num_threads,
+                                 coordinates);
+  });
+  if (!supported) {
+    cerr << "*** ERROR *** ";
+    cerr << "Remap supports CV_8U, CV_16U, CV_16S, CV_32F and CV_64F sources"
+         << endl;
+    return false;
+  }
 
-          dst.at<cv::Vec3b>(x, y)[chan] = static_cast<uint8_t>(
-              floor((DC_y_1 - DC_y) * (y_prime - y) + DC_y));
+  dst = converted;
+  return true;
+}
+
+// How the source neighborhood of a destination pixel is addressed
+enum class FootprintKind {
+  INSIDE, // entirely inside the source, from its top left tap
+  BORDER, // entirely outside under a constant border, the border value
+  MIXED   // tap by tap through extrapolated coordinates
+};
+
+/** Source neighborhood and interpolation weights of a destination pixel,
+ *  resolved once and shared by every band of a batch
+ */
+struct Footprint {
+  FootprintKind kind;
+  int x;     // top left tap (INSIDE) or sample (NEAREST)
+  int y;
+  int taps;  // first (row, col) pair of the extrapolated taps (MIXED)
+  int entry; // offset of the weights in the table
+};
+
+/** Resolves the source neighborhoods of n destination pixels
+ *
+ *  \param[in] size         size of the sources
+ *  \param[in] xy           n (x, y) pairs of integer source coordinates
+ *  \param[in] fraction     n fractional parts (unused for NEAREST)
+ *  \param[in] n            number of destination pixels
+ *  \param[in] table        interpolation weights (nullptr for NEAREST)
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[out] footprints  n footprints
+ *  \param[out] tap_coords  (row, col) pairs of the extrapolated taps of
+ *                          MIXED footprints, (-1, -1) for the border value
+ */
+static void PlanFootprints(const cv::Size size, const int16_t *xy,
+                           const uint16_t *fraction, const int n,
+                           const RemapWeights *table,
+                           const BorderMode border_mode,
+                           Footprint *footprints, vector<int> &tap_coords) {
+  tap_coords.clear();
+  for (int i = 0; i < n; i++) {
+    Footprint &fp = footprints[i];
+    int x = xy[2 * i];
+    int y = xy[2 * i + 1];
+    if (table == nullptr) {
+      if (static_cast<unsigned>(x) >= static_cast<unsigned>(size.width) ||
+          static_cast<unsigned>(y) >= static_cast<unsigned>(size.height)) {
+        x = BorderIndex(x, size.width, border_mode);
+        y = BorderIndex(y, size.height, border_mode);
+      }
+      fp.kind = x < 0 || y < 0 ? FootprintKind::BORDER : FootprintKind::INSIDE;
+      fp.x = x;
+      fp.y = y;
+      continue;
+    }
+
+    int ksize = table->ksize;
+    int x0 = x - (ksize / 2 - 1);
+    int y0 = y - (ksize / 2 - 1);
+    fp.x = x0;
+    fp.y = y0;
+    fp.entry = fraction[i] * ksize * ksize;
+    if (x0 >= 0 && x0 <= size.width - ksize && y0 >= 0 &&
+        y0 <= size.height - ksize) {
+      fp.kind = FootprintKind::INSIDE;
+    } else if (border_mode == BorderMode::CONSTANT &&
+               (x0 >= size.width || x0 + ksize <= 0 || y0 >= size.height ||
+                y0 + ksize <= 0)) {
+      fp.kind = FootprintKind::BORDER;
+    } else {
+      fp.kind = FootprintKind::MIXED;
+      fp.taps = static_cast<int>(tap_coords.size());
+      for (int ky = 0; ky < ksize; ky++) {
+        int sy = BorderIndex(y0 + ky, size.height, border_mode);
+        for (int kx = 0; kx < ksize; kx++) {
+          int sx = BorderIndex(x0 + kx, size.width, border_mode);
+          bool border = sx < 0 || sy < 0;
+          tap_coords.push_back(border ? -1 : sy);
+          tap_coords.push_back(border ? -1 : sx);
         }
-     /* 
-   } 
-    // Replicate pixels in border
-    if (border_mode == ipcv::BorderMode::REPLICATE) {
-      dst.at<cv::Vec3b>(x, y) =
-          // clamp pixel values to src pixel value range
-          src.at<cv::Vec3b>(clamp(x_prime, static_cast<float>(0),
-                                  static_cast<float>(src.rows-1)),
-                            clamp(y_prime, static_cast<float>(0),
-                                  static_cast<float>(src.cols-1)));
-      // constant color border
-    } else if (border_mode == ipcv::BorderMode::CONSTANT) {
-      if (x_prime < 0 || x_prime >= src.rows || y_prime < 0 ||
-          y_prime >= src.cols) { // for pixels that fall outside the src border
-        dst.at<cv::Vec3b>(x, y) = border_value;
-      } else {
-        dst.at<cv::Vec3b>(x, y) = src.at<cv::Vec3b>(x_prime, y_prime);
       }
     }
   }
-*/
 }
+
+/** Resamples n destination pixels of one band through resolved footprints
+ *
+ *  \param[in] band          source band
+ *  \param[in] footprints    n footprints
+ *  \param[in] tap_coords    extrapolated taps of MIXED footprints
+ *  \param[in] n             number of destination pixels
+ *  \param[in] table         interpolation weights (nullptr for NEAREST)
+ *  \param[in] border_pixel  band.channels() samples for constant border mode
+ *  \param[out] dst          n interleaved destination pixels
+ */
+template <typename T>
+static void ApplyFootprints(const cv::Mat &band, const Footprint *footprints,
+                            const vector<int> &tap_coords, const int n,
+                            const RemapWeights *table, const T *border_pixel,
+                            T *dst) {
+  int cn = band.channels();
+  int ksize = table == nullptr ? 1 : table->ksize;
+  int num_taps = ksize * ksize;
+  vector<const T *> taps(num_taps);
+  for (int i = 0; i < n; i++, dst += cn) {
+    const Footprint &fp = footprints[i];
+    if (fp.kind == FootprintKind::BORDER) {
+      copy(border_pixel, border_pixel + cn, dst);
+      continue;
+    }
+    if (table == nullptr) {
+      const T *pixel = band.ptr<T>(fp.y) + fp.x * cn;
+      copy(pixel, pixel + cn, dst);
+      continue;
+    }
+
+    if (fp.kind == FootprintKind::INSIDE) {
+      for (int ky = 0; ky < ksize; ky++) {
+        const T *row = band.ptr<T>(fp.y + ky) + fp.x * cn;
+        for (int kx = 0; kx < ksize; kx++) {
+          taps[ky * ksize + kx] = row + kx * cn;
+        }
+      }
+    } else {
+      const int *coords = &tap_coords[fp.taps];
+      for (int k = 0; k < num_taps; k++) {
+        taps[k] = coords[2 * k] < 0
+                      ? border_pixel
+                      : band.ptr<T>(coords[2 * k]) + coords[2 * k + 1] * cn;
+      }
+    }
+    const float *weights = &table->weights[fp.entry];
+    const int32_t *fixed = &table->fixed[fp.entry];
+    for (int ch = 0; ch < cn; ch++) {
+      dst[ch] = BlendTaps(taps.data(), num_taps, ch, weights, fixed);
+    }
+  }
 }
+
+/** Remap several co-registered source bands through the same map1, map2
+ *
+ *  \param[in] srcs           source bands of the same size, each of CV_8U,
+ *                            CV_16U, CV_16S, CV_32F or CV_64F with any
+ *                            number of channels
+ *  \param[out] dsts          destination bands of the types of srcs
+ *  \param[in] map1           cv::Mat of CV_32FC1 (size of the destination map)
+ *                            containing the horizontal (x) coordinates at
+ *                            which to resample the source data
+ *  \param[in] map2           cv::Mat of CV_32FC1 (size of the destination map)
+ *                            containing the vertical (y) coordinates at
+ *                            which to resample the source data
+ *  \param[in] interpolation  interpolation to be used for resampling
+ *  \param[in] border_mode    border mode to be used for out of bounds pixels
+ *  \param[in] border_value   border value to be used when constant border mode
+ *                            is to be used
+ *  \param[in] num_threads    number of worker threads the tiles are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
+ */
+bool RemapBatch(const vector<cv::Mat> &srcs, vector<cv::Mat> &dsts,
+                const cv::Mat &map1, const cv::Mat &map2,
+                const Interpolation interpolation,
+                const BorderMode border_mode, const uint8_t border_value,
+                const int num_threads) {
+  if (map1.type() != CV_32FC1 || map2.type() != CV_32FC1 ||
+      map1.size() != map2.size()) {
+    cerr << "*** ERROR *** ";
+    cerr << "RemapBatch needs map1 and map2 of CV_32FC1 and the same size"
+         << endl;
+    return false;
+  }
+  if (srcs.empty()) {
+    cerr << "*** ERROR *** ";
+    cerr << "RemapBatch needs at least one source band" << endl;
+    return false;
+  }
+  int num_bands = static_cast<int>(srcs.size());
+  vector<cv::Mat> converted(num_bands);
+  vector<cv::Mat> border_pixels(num_bands);
+  for (int b = 0; b < num_bands; b++) {
+    if (srcs[b].size() != srcs[0].size() ||
+        !WithSampleType(srcs[b].depth(), [](auto) {})) {
+      cerr << "*** ERROR *** ";
+      cerr << "RemapBatch needs source bands of the same size and of CV_8U, "
+              "CV_16U, CV_16S, CV_32F or CV_64F"
+           << endl;
+      return false;
+    }
+    // Destination bands are reused unless they share the data of a source
+    if (b < static_cast<int>(dsts.size()) &&
+        none_of(srcs.begin(), srcs.end(), [&](const cv::Mat &src) {
+          return src.data == dsts[b].data;
+        })) {
+      converted[b] = dsts[b];
+    }
+    converted[b].create(map1.size(), srcs[b].type());
+    border_pixels[b].create(1, srcs[b].channels(),
+                            CV_MAKETYPE(srcs[b].depth(), 1));
+    border_pixels[b].setTo(cv::Scalar::all(border_value));
+  }
+
+  // Each tile row of the maps is converted, and its neighborhoods and
+  // weights located, once for all of the bands
+  bool nearest = interpolation == Interpolation::NEAREST;
+  const RemapWeights *table =
+      nearest ? nullptr : &InterpolationWeights(interpolation);
+  cv::Size size = srcs[0].size();
+  vector<cv::Rect> tiles = ScheduleTiles(
+      srcs[0], map1.size(), num_threads,
+      [&](const int r, const int c, double &x, double &y) {
+        x = map1.at<float>(r, c);
+        y = map2.at<float>(r, c);
+        return !isnan(x) && !isnan(y);
+      });
+  int num_tiles = static_cast<int>(tiles.size());
+  ParallelFor(num_tiles, num_threads, [&](int begin, int end) {
+    vector<int16_t> xy(2 * kRemapTileCols);
+    vector<uint16_t> fraction(kRemapTileCols);
+    vector<Footprint> footprints(kRemapTileCols);
+    vector<int> tap_coords;
+    for (int idx = begin; idx < end; idx++) {
+      const cv::Rect &tile = tiles[idx];
+      for (int r = tile.y; r < tile.y + tile.height; r++) {
+        ConvertMapRow(map1.ptr<float>(r) + tile.x, map2.ptr<float>(r) + tile.x,
+                      tile.width, nearest, xy.data(), fraction.data());
+        PlanFootprints(size, xy.data(), fraction.data(), tile.width, table,
+                       border_mode, footprints.data(), tap_coords);
+        for (int b = 0; b < num_bands; b++) {
+          WithSampleType(srcs[b].depth(), [&](auto sample) {
+            using T = decltype(sample);
+            ApplyFootprints<T>(
+                srcs[b], footprints.data(), tap_coords, tile.width, table,
+                border_pixels[b].ptr<T>(0),
+                converted[b].ptr<T>(r) + tile.x * srcs[b].channels());
+          });
+        }
+      }
+    }
+  });
+
+  // New bands, if dsts were srcs, replace them only once resampling is done
+  dsts = converted;
+  return true;
 }
+
+/** Convert map1, map2 to the fixed point format of FixedPointMap
+ *
+ *  \param[in] map1           cv::Mat of CV_32FC1 containing the horizontal (x)
+ *                            source coordinates
+ *  \param[in] map2           cv::Mat of CV_32FC1 containing the vertical (y)
+ *                            source coordinates
+ *  \param[out] map           converted map
+ *  \param[in] interpolation  interpolation the map will be used with
+ *                            (coordinates are rounded for nearest neighbor)
+ */
+bool ConvertMaps(const cv::Mat &map1, const cv::Mat &map2, FixedPointMap &map,
+                 const Interpolation interpolation) {
+  if (map1.type() != CV_32FC1 || map2.type() != CV_32FC1 ||
+      map1.size() != map2.size()) {
+    cerr << "*** ERROR *** ";
+    cerr << "ConvertMaps needs map1 and map2 of CV_32FC1 and the same size"
+         << endl;
+    return false;
+  }
+
+  bool nearest = interpolation == Interpolation::NEAREST;
+  map.interpolation = interpolation;
+  map.xy.create(map1.size(), CV_16SC2);
+  if (nearest) {
+    map.fraction.release();
+  } else {
+    map.fraction.create(map1.size(), CV_16UC1);
+  }
+  for (int r = 0; r < map1.rows; r++) {
+    ConvertMapRow(map1.ptr<float>(r), map2.ptr<float>(r), map1.cols, nearest,
+                  map.xy.ptr<int16_t>(r),
+                  nearest ? nullptr : map.fraction.ptr<uint16_t>(r));
+  }
+
   return true;
 }
 } // namespace ipcv
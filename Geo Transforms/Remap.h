@@ -0,0 +1,136 @@
+/** Interface file for remapping source values to map locations
+ *
+ *  \file ipcv/geometric_transformation/Remap.h
+ *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
+ *  \edited: Andrea Avendano (aa6588@rit.edu)
+ *  \date 26 Sept 2020
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "imgs/ipcv/utils/BorderMode.h"
+
+namespace ipcv {
+
+// Available interpolation methods
+enum class Interpolation {
+  NEAREST, // Nearest neighbor
+  LINEAR,  // Bilinear
+  CUBIC,   // Bicubic over a 4 x 4 neighborhood
+  LANCZOS4 // Lanczos over an 8 x 8 neighborhood
+};
+
+/** Map converted to fixed point by ConvertMaps
+ *
+ *  Source coordinates are stored as their integer part and a fractional
+ *  part quantized to 1 / 32 pixel, which indexes precomputed interpolation
+ *  weights, so resampling does no rounding, clamping or weight computation
+ *  per pixel.  Source images must be less than 32768 pixels on a side.
+ */
+struct FixedPointMap {
+  cv::Mat xy;       // CV_16SC2 integer part of the (x, y) coordinates
+  cv::Mat fraction; // CV_16UC1 fractional parts, y * 32 + x [1 / 32 pixel]
+                    // (empty for nearest neighbor interpolation)
+  Interpolation interpolation;
+};
+
+/** Remap source values to the destination array at map1, map2 locations
+ *
+ *  The destination is resampled in tiles over a pool of threads.  Tiles
+ *  are visited in the order of the source regions they read rather than
+ *  their own, so that under rotations the source stays in cache.
+ *
+ *  \param[in] src            source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                            or CV_64F with any number of channels
+ *  \param[out] dst           destination cv::Mat of the src type for remapped
+ *                            values
+ *  \param[in] map1           cv::Mat of CV_32FC1 (size of the destination map)
+ *                            containing the horizontal (x) coordinates at
+ *                            which to resample the source data
+ *  \param[in] map2           cv::Mat of CV_32FC1 (size of the destination map)
+ *                            containing the vertical (y) coordinates at
+ *                            which to resample the source data
+ *  \param[in] interpolation  interpolation to be used for resampling
+ *  \param[in] border_mode    border mode to be used for out of bounds pixels
+ *  \param[in] border_value   border value to be used when constant border mode
+ *                            is to be used
+ *  \param[in] num_threads    number of worker threads the tiles are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
+ */
+bool Remap(const cv::Mat& src, cv::Mat& dst, const cv::Mat& map1,
+           const cv::Mat& map2,
+           const Interpolation interpolation = Interpolation::LINEAR,
+           const BorderMode border_mode = BorderMode::CONSTANT,
+           const uint8_t border_value = 0, const int num_threads = 0);
+
+/** Remap source values to the destination array at the locations of a map
+ *  converted to fixed point
+ *
+ *  Converting a map once with ConvertMaps and remapping every frame with
+ *  this overload avoids all of the per pixel coordinate arithmetic.
+ *
+ *  \param[in] src            source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                            or CV_64F with any number of channels
+ *  \param[out] dst           destination cv::Mat of the src type for remapped
+ *                            values
+ *  \param[in] map            map converted by ConvertMaps, which also selects
+ *                            the interpolation
+ *  \param[in] border_mode    border mode to be used for out of bounds pixels
+ *  \param[in] border_value   border value to be used when constant border mode
+ *                            is to be used
+ *  \param[in] num_threads    number of worker threads the tiles are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
+ */
+bool Remap(const cv::Mat& src, cv::Mat& dst, const FixedPointMap& map,
+           const BorderMode border_mode = BorderMode::CONSTANT,
+           const uint8_t border_value = 0, const int num_threads = 0);
+
+/** Remap several co-registered source bands through the same map1, map2
+ *
+ *  Each map entry is converted, and the source neighborhood and weights it
+ *  selects are located, once for all of the bands, so the map is read once
+ *  instead of once per band.  Each band gives the same result as Remap.
+ *
+ *  \param[in] srcs           source bands of the same size, each of CV_8U,
+ *                            CV_16U, CV_16S, CV_32F or CV_64F with any
+ *                            number of channels
+ *  \param[out] dsts          destination bands of the types of srcs
+ *  \param[in] map1           cv::Mat of CV_32FC1 (size of the destination map)
+ *                            containing the horizontal (x) coordinates at
+ *                            which to resample the source data
+ *  \param[in] map2           cv::Mat of CV_32FC1 (size of the destination map)
+ *                            containing the vertical (y) coordinates at
+ *                            which to resample the source data
+ *  \param[in] interpolation  interpolation to be used for resampling
+ *  \param[in] border_mode    border mode to be used for out of bounds pixels
+ *  \param[in] border_value   border value to be used when constant border mode
+ *                            is to be used
+ *  \param[in] num_threads    number of worker threads the tiles are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
+ */
+bool RemapBatch(const std::vector<cv::Mat>& srcs, std::vector<cv::Mat>& dsts,
+                const cv::Mat& map1, const cv::Mat& map2,
+                const Interpolation interpolation = Interpolation::LINEAR,
+                const BorderMode border_mode = BorderMode::CONSTANT,
+                const uint8_t border_value = 0, const int num_threads = 0);
+
+/** Convert map1, map2 to the fixed point format of FixedPointMap
+ *
+ *  \param[in] map1           cv::Mat of CV_32FC1 containing the horizontal (x)
+ *                            source coordinates
+ *  \param[in] map2           cv::Mat of CV_32FC1 containing the vertical (y)
+ *                            source coordinates
+ *  \param[out] map           converted map
+ *  \param[in] interpolation  interpolation the map will be used with
+ *                            (coordinates are rounded for nearest neighbor)
+ */
+bool ConvertMaps(const cv::Mat& map1, const cv::Mat& map2, FixedPointMap& map,
+                 const Interpolation interpolation = Interpolation::LINEAR);
+}
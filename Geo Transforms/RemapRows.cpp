@@ -0,0 +1,224 @@
+/** Implementation file for the row kernels shared by the remapping paths
+ *
+ *  \file ipcv/geometric_transformation/RemapRows.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "RemapRows.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace ipcv {
+
+#if defined(__AVX2__)
+/** Loads the integer coordinates of 8 pixels and checks that their
+ *  neighborhoods lie inside the source
+ *
+ *  Offsets are 32-bit gather indices, so they are taken from the top row
+ *  of the block's neighborhoods rather than the start of the source, which
+ *  may be larger than 2^31 samples.
+ *
+ *  \param[in] src         source cv::Mat
+ *  \param[in] xy          8 (x, y) pairs of integer source coordinates
+ *  \param[in] ksize       size of the 1D interpolation kernel
+ *  \param[in] last_rows   rows at the bottom of the source that no
+ *                         neighborhood may reach (gathers of 8-bit samples
+ *                         read 3 bytes past the sample they need)
+ *  \param[out] offsets    sample offsets of the top left taps from the
+ *                         start of base_row
+ *  \param[out] base_row   top row of the neighborhoods
+ *
+ *  \return                false if a neighborhood is (partly) outside, or
+ *                         the neighborhoods span more than 32-bit offsets
+ *                         reach
+ */
+static bool BlockOffsets(const cv::Mat &src, const int16_t *xy,
+                         const int ksize, const int last_rows,
+                         __m256i &offsets, int &base_row) {
+  int offset = ksize / 2 - 1;
+  int max_x0 = src.cols - ksize;
+  int max_y0 = src.rows - ksize - last_rows;
+  int top = max_y0;
+  int bottom = 0;
+  for (int i = 0; i < 8; i++) {
+    int x0 = xy[2 * i] - offset;
+    int y0 = xy[2 * i + 1] - offset;
+    if (x0 < 0 || x0 > max_x0 || y0 < 0 || y0 > max_y0) {
+      return false;
+    }
+    top = min(top, y0);
+    bottom = max(bottom, y0);
+  }
+
+  // Largest sample offset reached, with the 3 bytes 8-bit gathers read past
+  // the last sample
+  int64_t step_samples = static_cast<int64_t>(src.step[0] / src.elemSize1());
+  int64_t reach = (bottom - top + ksize) * step_samples +
+                  static_cast<int64_t>(src.cols) * src.channels() + 3;
+  if (reach > INT32_MAX) {
+    return false;
+  }
+
+  // Each (x, y) pair is one 32-bit lane, x in the low half
+  __m256i pairs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(xy));
+  __m256i x = _mm256_srai_epi32(_mm256_slli_epi32(pairs, 16), 16);
+  __m256i y = _mm256_srai_epi32(pairs, 16);
+  x = _mm256_sub_epi32(x, _mm256_set1_epi32(offset));
+  y = _mm256_sub_epi32(y, _mm256_set1_epi32(offset + top));
+  int step = static_cast<int>(step_samples);
+  __m256i cn = _mm256_set1_epi32(src.channels());
+  offsets = _mm256_add_epi32(_mm256_mullo_epi32(y, _mm256_set1_epi32(step)),
+                             _mm256_mullo_epi32(x, cn));
+  base_row = top;
+  return true;
+}
+
+/** Offsets of the first weight of the 8 table entries */
+static __m256i WeightOffsets(const uint16_t *fraction, const int num_taps) {
+  __m256i index = _mm256_cvtepu16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(fraction)));
+  return _mm256_mullo_epi32(index, _mm256_set1_epi32(num_taps));
+}
+#endif
+
+/** Resamples 8 pixels of an 8-bit source with vector gathers
+ *
+ *  \param[in] src    source cv::Mat with at most 4 channels
+ *  \param[in] xy     8 (x, y) pairs of integer source coordinates
+ *  \param[in] fraction
+ *                    8 fractional parts
+ *  \param[in] table  interpolation weights
+ *  \param[out] dst   8 interleaved destination pixels
+ *
+ *  \return           false, leaving dst untouched, if a neighborhood is not
+ *                    entirely inside the source or the build has no AVX2
+ */
+bool GatherBlock(const cv::Mat &src, const int16_t *xy,
+                 const uint16_t *fraction, const RemapWeights &table,
+                 uint8_t *dst) {
+#if defined(__AVX2__)
+  int cn = src.channels();
+  __m256i offsets;
+  int base_row;
+  if (cn > 4 || !BlockOffsets(src, xy, table.ksize, 1, offsets, base_row)) {
+    return false;
+  }
+
+  // Every tap is gathered as the 32-bit word starting at its sample and
+  // masked down to that byte; the same integer weights and rounding as
+  // the scalar path keep the results identical
+  const int ksize = table.ksize;
+  const int num_taps = ksize * ksize;
+  const int step = static_cast<int>(src.step[0]);
+  const int *base =
+      reinterpret_cast<const int *>(src.ptr<uint8_t>(base_row));
+  const __m256i mask = _mm256_set1_epi32(0xFF);
+  __m256i weight_offsets = WeightOffsets(fraction, num_taps);
+  __m256i acc[4];
+  for (int ch = 0; ch < cn; ch++) {
+    acc[ch] = _mm256_set1_epi32(1 << (kRemapWeightBits - 1));
+  }
+  for (int ky = 0; ky < ksize; ky++) {
+    for (int kx = 0; kx < ksize; kx++) {
+      int k = ky * ksize + kx;
+      __m256i w = _mm256_i32gather_epi32(
+          &table.fixed[k], weight_offsets, sizeof(int32_t));
+      __m256i tap = _mm256_add_epi32(offsets,
+                                     _mm256_set1_epi32(ky * step + kx * cn));
+      for (int ch = 0; ch < cn; ch++) {
+        __m256i samples = _mm256_and_si256(
+            _mm256_i32gather_epi32(
+                base, _mm256_add_epi32(tap, _mm256_set1_epi32(ch)), 1),
+            mask);
+        acc[ch] = _mm256_add_epi32(acc[ch], _mm256_mullo_epi32(w, samples));
+      }
+    }
+  }
+
+  // Kernels with negative lobes overshoot, so results are clamped to the
+  // 8-bit range before they are narrowed
+  alignas(32) int32_t out[8];
+  for (int ch = 0; ch < cn; ch++) {
+    __m256i v = _mm256_srai_epi32(acc[ch], kRemapWeightBits);
+    v = _mm256_min_epi32(_mm256_max_epi32(v, _mm256_setzero_si256()), mask);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(out), v);
+    for (int i = 0; i < 8; i++) {
+      dst[i * cn + ch] = static_cast<uint8_t>(out[i]);
+    }
+  }
+  return true;
+#else
+  (void)src;
+  (void)xy;
+  (void)fraction;
+  (void)table;
+  (void)dst;
+  return false;
+#endif
+}
+
+/** Resamples 8 pixels of a single precision source with vector gathers */
+bool GatherBlock(const cv::Mat &src, const int16_t *xy,
+                 const uint16_t *fraction, const RemapWeights &table,
+                 float *dst) {
+#if defined(__AVX2__)
+  int cn = src.channels();
+  __m256i offsets;
+  int base_row;
+  if (cn > 4 || !BlockOffsets(src, xy, table.ksize, 0, offsets, base_row)) {
+    return false;
+  }
+
+  // Products are accumulated in the order of the scalar path, with
+  // separate multiplies and adds, so the results match it
+  const int ksize = table.ksize;
+  const int num_taps = ksize * ksize;
+  const int step = static_cast<int>(src.step[0] / sizeof(float));
+  const float *base = src.ptr<float>(base_row);
+  __m256i weight_offsets = WeightOffsets(fraction, num_taps);
+  __m256 acc[4];
+  for (int ch = 0; ch < cn; ch++) {
+    acc[ch] = _mm256_setzero_ps();
+  }
+  for (int ky = 0; ky < ksize; ky++) {
+    for (int kx = 0; kx < ksize; kx++) {
+      int k = ky * ksize + kx;
+      __m256 w = _mm256_i32gather_ps(&table.weights[k], weight_offsets,
+                                     sizeof(float));
+      __m256i tap = _mm256_add_epi32(offsets,
+                                     _mm256_set1_epi32(ky * step + kx * cn));
+      for (int ch = 0; ch < cn; ch++) {
+        __m256 samples = _mm256_i32gather_ps(
+            base, _mm256_add_epi32(tap, _mm256_set1_epi32(ch)),
+            sizeof(float));
+        acc[ch] = _mm256_add_ps(acc[ch], _mm256_mul_ps(w, samples));
+      }
+    }
+  }
+
+  alignas(32) float out[8];
+  for (int ch = 0; ch < cn; ch++) {
+    _mm256_store_ps(out, acc[ch]);
+    for (int i = 0; i < 8; i++) {
+      dst[i * cn + ch] = out[i];
+    }
+  }
+  return true;
+#else
+  (void)src;
+  (void)xy;
+  (void)fraction;
+  (void)table;
+  (void)dst;
+  return false;
+#endif
+}
+} // namespace ipcv
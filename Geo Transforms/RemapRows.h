@@ -0,0 +1,324 @@
+/** Interface file for the row kernels shared by the remapping paths
+ *
+ *  These are building blocks of Remap and its variants, not part of the
+ *  public remapping interface.
+ *
+ *  \file ipcv/geometric_transformation/RemapRows.h
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "Remap.h"
+
+namespace ipcv {
+
+// Bits of the fractional part of fixed point source coordinates
+const int kRemapBits = 5;
+const int kRemapTableSize = 1 << kRemapBits;
+
+// Bits of the integer interpolation weights used for 8-bit sources
+const int kRemapWeightBits = 15;
+
+// Destination tiles are square-ish, so that the source footprint of a tile
+// stays compact under rotations
+const int kRemapTileRows = 64;
+const int kRemapTileCols = 128;
+
+/** Calls body with a value of the sample type of a depth
+ *
+ *  \return  false if the depth is not supported
+ */
+template <typename Body>
+bool WithSampleType(const int depth, Body body) {
+  switch (depth) {
+  case CV_8U:
+    body(uint8_t());
+    return true;
+  case CV_16U:
+    body(uint16_t());
+    return true;
+  case CV_16S:
+    body(int16_t());
+    return true;
+  case CV_32F:
+    body(float());
+    return true;
+  case CV_64F:
+    body(double());
+    return true;
+  }
+  return false;
+}
+
+/** Image a resampling of src writes to: dst itself, reallocated only if its
+ *  size or type differ, so callers remapping every frame reuse it, or a new
+ *  image if dst shares the data of src, which is read while resampling
+ *
+ *  \param[in] src   source cv::Mat
+ *  \param[in] dst   destination cv::Mat given by the caller
+ *  \param[in] size  size of the destination
+ *  \param[in] type  type of the destination
+ *
+ *  \return          cv::Mat to resample to and assign to dst afterwards
+ */
+inline cv::Mat ResampleTarget(const cv::Mat& src, const cv::Mat& dst,
+                              const cv::Size size, const int type) {
+  cv::Mat target;
+  if (dst.data != src.data) {
+    target = dst;
+  }
+  target.create(size, type);
+  return target;
+}
+
+/** Interpolation weights of every quantized fractional offset
+ *
+ *  Entry fraction (y * kRemapTableSize + x) holds the ksize * ksize weights
+ *  of the source neighborhood, row by row, starting ksize / 2 - 1 pixels
+ *  above and left of the integer coordinates.  The fixed point weights are
+ *  scaled by 2^kRemapWeightBits and sum to exactly that.
+ */
+struct RemapWeights {
+  int ksize;
+  std::vector<float> weights;
+  std::vector<int32_t> fixed;
+};
+
+/** Interpolation weights for an interpolation method, computed on first use
+ *
+ *  \param[in] interpolation  interpolation method (not NEAREST)
+ *
+ *  \return                   weight table
+ */
+const RemapWeights& InterpolationWeights(const Interpolation interpolation);
+
+/** Converts n map coordinates to fixed point
+ *
+ *  \param[in] map_x      horizontal source coordinates
+ *  \param[in] map_y      vertical source coordinates
+ *  \param[in] n          number of coordinates
+ *  \param[in] nearest    whether to round to the nearest pixel instead of
+ *                        quantizing the fractional part
+ *  \param[out] xy        n (x, y) pairs of integer coordinates
+ *  \param[out] fraction  n fractional parts (not written if nearest)
+ */
+void ConvertMapRow(const float* map_x, const float* map_y, const int n,
+                   const bool nearest, int16_t* xy, uint16_t* fraction);
+
+/** Converts n double precision coordinates to fixed point */
+void ConvertMapRow(const double* map_x, const double* map_y, const int n,
+                   const bool nearest, int16_t* xy, uint16_t* fraction);
+
+/** Resamples n nearest neighbor pixels of a source of type T
+ *
+ *  \param[in] src           source cv::Mat
+ *  \param[in] xy            n (x, y) pairs of source coordinates
+ *  \param[in] n             number of destination pixels
+ *  \param[in] border_mode   pixel extrapolation method
+ *  \param[in] border_pixel  src.channels() samples for constant border mode
+ *  \param[out] dst          n interleaved destination pixels
+ */
+template <typename T>
+void NearestRow(const cv::Mat& src, const int16_t* xy, const int n,
+                const BorderMode border_mode, const T* border_pixel, T* dst) {
+  int cn = src.channels();
+  for (int i = 0; i < n; i++, dst += cn) {
+    int x = xy[2 * i];
+    int y = xy[2 * i + 1];
+    if (static_cast<unsigned>(x) >= static_cast<unsigned>(src.cols) ||
+        static_cast<unsigned>(y) >= static_cast<unsigned>(src.rows)) {
+      x = BorderIndex(x, src.cols, border_mode);
+      y = BorderIndex(y, src.rows, border_mode);
+      if (x < 0 || y < 0) {
+        std::copy(border_pixel, border_pixel + cn, dst);
+        continue;
+      }
+    }
+    const T* pixel = src.ptr<T>(y) + x * cn;
+    std::copy(pixel, pixel + cn, dst);
+  }
+}
+
+/** Weighted sum of the taps of one channel, rounded to the sample type */
+template <typename T>
+inline T BlendTaps(const T* const* taps, const int num_taps, const int ch,
+                   const float* weights, const int32_t*) {
+  float sum = 0;
+  for (int k = 0; k < num_taps; k++) {
+    sum += weights[k] * taps[k][ch];
+  }
+  return cv::saturate_cast<T>(sum);
+}
+
+inline double BlendTaps(const double* const* taps, const int num_taps,
+                        const int ch, const float* weights, const int32_t*) {
+  double sum = 0;
+  for (int k = 0; k < num_taps; k++) {
+    sum += weights[k] * taps[k][ch];
+  }
+  return sum;
+}
+
+/** 8-bit samples are blended exactly in integers with the fixed point
+ *  weights
+ */
+inline uint8_t BlendTaps(const uint8_t* const* taps, const int num_taps,
+                         const int ch, const float*, const int32_t* fixed) {
+  int32_t sum = 1 << (kRemapWeightBits - 1);
+  for (int k = 0; k < num_taps; k++) {
+    sum += fixed[k] * taps[k][ch];
+  }
+  return cv::saturate_cast<uint8_t>(sum >> kRemapWeightBits);
+}
+
+/** Resamples 8 pixels of an 8-bit source with vector gathers
+ *
+ *  \param[in] src    source cv::Mat with at most 4 channels
+ *  \param[in] xy     8 (x, y) pairs of integer source coordinates
+ *  \param[in] fraction
+ *                    8 fractional parts
+ *  \param[in] table  interpolation weights
+ *  \param[out] dst   8 interleaved destination pixels
+ *
+ *  \return           false, leaving dst untouched, if a neighborhood is not
+ *                    entirely inside the source or the build has no AVX2
+ */
+bool GatherBlock(const cv::Mat& src, const int16_t* xy,
+                 const uint16_t* fraction, const RemapWeights& table,
+                 uint8_t* dst);
+
+/** Resamples 8 pixels of a single precision source with vector gathers */
+bool GatherBlock(const cv::Mat& src, const int16_t* xy,
+                 const uint16_t* fraction, const RemapWeights& table,
+                 float* dst);
+
+/** Other sample types have no vector path */
+template <typename T>
+inline bool GatherBlock(const cv::Mat&, const int16_t*, const uint16_t*,
+                        const RemapWeights&, T*) {
+  return false;
+}
+
+/** Resamples one interpolated pixel of a source of type T
+ *
+ *  \param[in] src           source cv::Mat
+ *  \param[in] x             integer horizontal source coordinate
+ *  \param[in] y             integer vertical source coordinate
+ *  \param[in] fraction      fractional part
+ *  \param[in] table         interpolation weights
+ *  \param[in] border_mode   pixel extrapolation method
+ *  \param[in] border_pixel  src.channels() samples for constant border mode
+ *  \param[in] taps          scratch space for ksize * ksize tap pointers
+ *  \param[out] dst          destination pixel
+ */
+template <typename T>
+void InterpolatePixel(const cv::Mat& src, const int x, const int y,
+                      const uint16_t fraction, const RemapWeights& table,
+                      const BorderMode border_mode, const T* border_pixel,
+                      const T** taps, T* dst) {
+  int cn = src.channels();
+  int ksize = table.ksize;
+  int num_taps = ksize * ksize;
+  int x0 = x - (ksize / 2 - 1);
+  int y0 = y - (ksize / 2 - 1);
+
+  // Neighborhoods inside the source are addressed directly; only those
+  // overlapping the border extrapolate each tap
+  if (x0 >= 0 && x0 <= src.cols - ksize && y0 >= 0 &&
+      y0 <= src.rows - ksize) {
+    for (int ky = 0; ky < ksize; ky++) {
+      const T* row = src.ptr<T>(y0 + ky) + x0 * cn;
+      for (int kx = 0; kx < ksize; kx++) {
+        taps[ky * ksize + kx] = row + kx * cn;
+      }
+    }
+  } else if (border_mode == BorderMode::CONSTANT &&
+             (x0 >= src.cols || x0 + ksize <= 0 || y0 >= src.rows ||
+              y0 + ksize <= 0)) {
+    std::copy(border_pixel, border_pixel + cn, dst);
+    return;
+  } else {
+    for (int ky = 0; ky < ksize; ky++) {
+      int sy = BorderIndex(y0 + ky, src.rows, border_mode);
+      for (int kx = 0; kx < ksize; kx++) {
+        int sx = BorderIndex(x0 + kx, src.cols, border_mode);
+        taps[ky * ksize + kx] =
+            sx < 0 || sy < 0 ? border_pixel : src.ptr<T>(sy) + sx * cn;
+      }
+    }
+  }
+
+  const float* weights = &table.weights[fraction * num_taps];
+  const int32_t* fixed = &table.fixed[fraction * num_taps];
+  for (int ch = 0; ch < cn; ch++) {
+    dst[ch] = BlendTaps(taps, num_taps, ch, weights, fixed);
+  }
+}
+
+/** Resamples n interpolated pixels of a source of type T
+ *
+ *  \param[in] src           source cv::Mat
+ *  \param[in] xy            n (x, y) pairs of integer source coordinates
+ *  \param[in] fraction      n fractional parts
+ *  \param[in] n             number of destination pixels
+ *  \param[in] table         interpolation weights
+ *  \param[in] border_mode   pixel extrapolation method
+ *  \param[in] border_pixel  src.channels() samples for constant border mode
+ *  \param[out] dst          n interleaved destination pixels
+ */
+template <typename T>
+void InterpolateRow(const cv::Mat& src, const int16_t* xy,
+                    const uint16_t* fraction, const int n,
+                    const RemapWeights& table, const BorderMode border_mode,
+                    const T* border_pixel, T* dst) {
+  int cn = src.channels();
+  std::vector<const T*> taps(table.ksize * table.ksize);
+  int i = 0;
+  while (i < n) {
+    // Blocks of 8 pixels are gathered at once where the source type allows
+    // it; blocks touching the border fall back to one pixel at a time
+    int end = std::min(i + 8, n);
+    if (end - i == 8 &&
+        GatherBlock(src, xy + 2 * i, fraction + i, table, dst + i * cn)) {
+      i = end;
+      continue;
+    }
+    for (; i < end; i++) {
+      InterpolatePixel<T>(src, xy[2 * i], xy[2 * i + 1], fraction[i], table,
+                          border_mode, border_pixel, taps.data(),
+                          dst + i * cn);
+    }
+  }
+}
+
+/** Resamples one row of destination pixels at fixed point coordinates
+ *
+ *  \param[in] src            source cv::Mat
+ *  \param[in] xy             n (x, y) pairs of integer source coordinates
+ *  \param[in] fraction       n fractional parts (unused for NEAREST)
+ *  \param[in] n              number of destination pixels
+ *  \param[in] interpolation  interpolation method
+ *  \param[in] border_mode    pixel extrapolation method
+ *  \param[in] border_pixel   src.channels() samples for constant border mode
+ *  \param[out] dst           n interleaved destination pixels
+ */
+template <typename T>
+void RemapRow(const cv::Mat& src, const int16_t* xy, const uint16_t* fraction,
+              const int n, const Interpolation interpolation,
+              const BorderMode border_mode, const T* border_pixel, T* dst) {
+  if (interpolation == Interpolation::NEAREST) {
+    NearestRow<T>(src, xy, n, border_mode, border_pixel, dst);
+  } else {
+    InterpolateRow<T>(src, xy, fraction, n,
+                      InterpolationWeights(interpolation), border_mode,
+                      border_pixel, dst);
+  }
+}
+}
@@ -0,0 +1,268 @@
+/** Implementation file for warping images through a geometric
+ *  transformation without intermediate maps
+ *
+ *  \file ipcv/geometric_transformation/Warp.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "Warp.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "RemapRows.h"
+#include "imgs/ipcv/utils/Parallel.h"
+
+using namespace std;
+
+namespace ipcv {
+
+/** Source coordinates of consecutive destination pixels of one row
+ *
+ *  \param[in] transform  transformation with CV_64F coefficients
+ *  \param[in] row        destination row
+ *  \param[in] col        first destination column
+ *  \param[in] n          number of pixels
+ *  \param[out] x         n horizontal source coordinates
+ *  \param[out] y         n vertical source coordinates
+ */
+static void SourceRow(const Transform &transform, const int row, const int col,
+                      const int n, double *x, double *y) {
+  const cv::Mat &a = transform.coefficients;
+  switch (transform.type) {
+  case TransformType::AFFINE: {
+    // Both coordinates are linear along the row
+    const double *ax = a.ptr<double>(0);
+    const double *ay = a.ptr<double>(1);
+    double sx = ax[0] * col + ax[1] * row + ax[2];
+    double sy = ay[0] * col + ay[1] * row + ay[2];
+    for (int i = 0; i < n; i++) {
+      x[i] = sx;
+      y[i] = sy;
+      sx += ax[0];
+      sy += ay[0];
+    }
+    break;
+  }
+  case TransformType::PROJECTIVE: {
+    // The homogeneous coordinates are linear along the row; only the
+    // division is done per pixel
+    const double *h0 = a.ptr<double>(0);
+    const double *h1 = a.ptr<double>(1);
+    const double *h2 = a.ptr<double>(2);
+    double sx = h0[0] * col + h0[1] * row + h0[2];
+    double sy = h1[0] * col + h1[1] * row + h1[2];
+    double sw = h2[0] * col + h2[1] * row + h2[2];
+    for (int i = 0; i < n; i++) {
+      x[i] = sx / sw;
+      y[i] = sy / sw;
+      sx += h0[0];
+      sy += h1[0];
+      sw += h2[0];
+    }
+    break;
+  }
+  case TransformType::POLYNOMIAL: {
+    // Along a row each coordinate is a polynomial in x alone, whose
+    // forward differences of order transform.order are constant
+    int order = transform.order;
+    vector<double> c(order + 1);
+    vector<double> d(order + 1);
+    for (int coordinate = 0; coordinate < 2; coordinate++) {
+      const double *terms = a.ptr<double>(coordinate);
+      fill(c.begin(), c.end(), 0.0);
+      double y_power = 1;
+      int term = 0;
+      for (int j = 0; j <= order; j++) {
+        for (int i = 0; i <= order - j; i++) {
+          c[i] += terms[term++] * y_power;
+        }
+        y_power *= row;
+      }
+
+      // Values at the first order + 1 columns (Horner form in x), turned
+      // into the forward difference table
+      for (int k = 0; k <= order; k++) {
+        double value = 0;
+        for (int i = order; i >= 0; i--) {
+          value = value * (col + k) + c[i];
+        }
+        d[k] = value;
+      }
+      for (int level = 1; level <= order; level++) {
+        for (int k = order; k >= level; k--) {
+          d[k] -= d[k - 1];
+        }
+      }
+
+      double *out = coordinate == 0 ? x : y;
+      for (int p = 0; p < n; p++) {
+        out[p] = d[0];
+        for (int k = 0; k < order; k++) {
+          d[k] += d[k + 1];
+        }
+      }
+    }
+    break;
+  }
+  }
+}
+
+/** Checks the coefficient matrix of a transformation and converts it to
+ *  CV_64F
+ *
+ *  \param[in] transform   transformation
+ *  \param[out] converted  transformation with CV_64F coefficients
+ *
+ *  \return                false if the coefficients do not have the shape
+ *                         of the transformation type
+ */
+static bool PrepareTransform(const Transform &transform,
+                             Transform &converted) {
+  const cv::Mat &a = transform.coefficients;
+  bool valid = a.channels() == 1;
+  switch (transform.type) {
+  case TransformType::AFFINE:
+    valid = valid && a.rows == 2 && a.cols == 3;
+    break;
+  case TransformType::PROJECTIVE:
+    valid = valid && a.rows == 3 && a.cols == 3;
+    break;
+  case TransformType::POLYNOMIAL:
+    valid = valid && transform.order >= 1 && a.rows == 2 &&
+            a.cols == (transform.order + 1) * (transform.order + 2) / 2;
+    break;
+  }
+  if (!valid) {
+    return false;
+  }
+  converted.type = transform.type;
+  converted.order = transform.order;
+  a.convertTo(converted.coefficients, CV_64F);
+  return true;
+}
+
+/** Warp a source image through a transformation
+ *
+ *  \param[in] src            source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                            or CV_64F with any number of channels
+ *  \param[out] dst           destination cv::Mat of the src type
+ *  \param[in] dst_size       size of the destination
+ *  \param[in] transform      destination to source transformation
+ *  \param[in] interpolation  interpolation to be used for resampling
+ *  \param[in] border_mode    border mode to be used for out of bounds pixels
+ *  \param[in] border_value   border value to be used when constant border mode
+ *                            is to be used
+ *  \param[in] num_threads    number of worker threads the tiles are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
+ */
+bool Warp(const cv::Mat &src, cv::Mat &dst, const cv::Size dst_size,
+          const Transform &transform, const Interpolation interpolation,
+          const BorderMode border_mode, const uint8_t border_value,
+          const int num_threads) {
+  Transform prepared;
+  if (!PrepareTransform(transform, prepared)) {
+    cerr << "*** ERROR *** ";
+    cerr << "Warp needs 2 x 3 affine, 3 x 3 projective or 2 x terms "
+            "polynomial coefficients"
+         << endl;
+    return false;
+  }
+  cv::Mat warped = ResampleTarget(src, dst, dst_size, src.type());
+
+  int tiles_x = (dst_size.width + kRemapTileCols - 1) / kRemapTileCols;
+  int tiles_y = (dst_size.height + kRemapTileRows - 1) / kRemapTileRows;
+  bool nearest = interpolation == Interpolation::NEAREST;
+  bool supported = WithSampleType(src.depth(), [&](auto sample) {
+    using T = decltype(sample);
+    vector<T> border_pixel(src.channels(), cv::saturate_cast<T>(border_value));
+    ParallelFor(tiles_x * tiles_y, num_threads, [&](int begin, int end) {
+      vector<double> x(kRemapTileCols);
+      vector<double> y(kRemapTileCols);
+      vector<int16_t> xy(2 * kRemapTileCols);
+      vector<uint16_t> fraction(kRemapTileCols);
+      for (int idx = begin; idx < end; idx++) {
+        int col = (idx % tiles_x) * kRemapTileCols;
+        int row0 = (idx / tiles_x) * kRemapTileRows;
+        int n = min(kRemapTileCols, dst_size.width - col);
+        int row_end = min(row0 + kRemapTileRows, dst_size.height);
+        for (int r = row0; r < row_end; r++) {
+          SourceRow(prepared, r, col, n, x.data(), y.data());
+          ConvertMapRow(x.data(), y.data(), n, nearest, xy.data(),
+                        fraction.data());
+          RemapRow<T>(src, xy.data(), fraction.data(), n, interpolation,
+                      border_mode, border_pixel.data(),
+                      warped.ptr<T>(r) + col * src.channels());
+        }
+      }
+    });
+  });
+  if (!supported) {
+    cerr << "*** ERROR *** ";
+    cerr << "Warp supports CV_8U, CV_16U, CV_16S, CV_32F and CV_64F sources"
+         << endl;
+    return false;
+  }
+
+  // A new image, if dst was src, replaces it only once warping is done
+  dst = warped;
+  return true;
+}
+
+/** Convert a transformation to a map in the fixed point format of
+ *  FixedPointMap
+ *
+ *  \param[in] transform      destination to source transformation
+ *  \param[in] map_size       size of the destination map
+ *  \param[out] map           converted map
+ *  \param[in] interpolation  interpolation the map will be used with
+ *                            (coordinates are rounded for nearest neighbor)
+ *  \param[in] num_threads    number of worker threads the rows are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
+ */
+bool ConvertTransform(const Transform &transform, const cv::Size map_size,
+                      FixedPointMap &map, const Interpolation interpolation,
+                      const int num_threads) {
+  Transform prepared;
+  if (!PrepareTransform(transform, prepared)) {
+    cerr << "*** ERROR *** ";
+    cerr << "ConvertTransform needs 2 x 3 affine, 3 x 3 projective or "
+            "2 x terms polynomial coefficients"
+         << endl;
+    return false;
+  }
+
+  bool nearest = interpolation == Interpolation::NEAREST;
+  map.interpolation = interpolation;
+  map.xy.create(map_size, CV_16SC2);
+  if (nearest) {
+    map.fraction.release();
+  } else {
+    map.fraction.create(map_size, CV_16UC1);
+  }
+  ParallelFor(
+      map_size.height, num_threads,
+      [&](int begin, int end) {
+        vector<double> x(map_size.width);
+        vector<double> y(map_size.width);
+        for (int r = begin; r < end; r++) {
+          // Reseeded every kRemapTileCols columns as in Warp, so polynomial
+          // forward differences do not accumulate error across wide rows
+          for (int col = 0; col < map_size.width; col += kRemapTileCols) {
+            int n = min(kRemapTileCols, map_size.width - col);
+            SourceRow(prepared, r, col, n, x.data() + col, y.data() + col);
+          }
+          ConvertMapRow(x.data(), y.data(), map_size.width, nearest,
+                        map.xy.ptr<int16_t>(r),
+                        nearest ? nullptr : map.fraction.ptr<uint16_t>(r));
+        }
+      },
+      16);
+
+  return true;
+}
+} // namespace ipcv
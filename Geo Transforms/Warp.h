@@ -0,0 +1,84 @@
+/** Interface file for warping images through a geometric transformation
+ *  without intermediate maps
+ *
+ *  \file ipcv/geometric_transformation/Warp.h
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include "Remap.h"
+
+namespace ipcv {
+
+// Available geometric transformations
+enum class TransformType {
+  AFFINE,     // 2 x 3 matrix applied to (x, y, 1)
+  PROJECTIVE, // 3 x 3 homography applied to (x, y, 1)
+  POLYNOMIAL  // Polynomials in x and y of the MapGCP form
+};
+
+/** Transformation from destination (map) pixel coordinates (x, y) to the
+ *  source coordinates at which to resample, as map1, map2 would hold them
+ *
+ *  POLYNOMIAL coefficients are two rows (source x, then source y) of
+ *  (order + 1)(order + 2) / 2 terms, ordered as in MapGCP:
+ *    x^0*y^0, x^1*y^0, ..., x^order*y^0, x^0*y^1, ..., x^0*y^order
+ */
+struct Transform {
+  TransformType type;
+  cv::Mat coefficients; // CV_64FC1 (2 x 3, 3 x 3 or 2 x terms)
+  int order;            // polynomial order (POLYNOMIAL only)
+};
+
+/** Warp a source image through a transformation
+ *
+ *  The transformation is evaluated tile by tile inside the resampler, with
+ *  coordinates advanced by forward differences along each row, so no map
+ *  is ever stored and the only memory traffic is the source and dst.  The
+ *  result is that of Remap with maps of the same transformation (up to
+ *  coordinates rounding differently to 1 / 32 pixel).
+ *
+ *  \param[in] src            source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                            or CV_64F with any number of channels
+ *  \param[out] dst           destination cv::Mat of the src type
+ *  \param[in] dst_size       size of the destination
+ *  \param[in] transform      destination to source transformation
+ *  \param[in] interpolation  interpolation to be used for resampling
+ *  \param[in] border_mode    border mode to be used for out of bounds pixels
+ *  \param[in] border_value   border value to be used when constant border mode
+ *                            is to be used
+ *  \param[in] num_threads    number of worker threads the tiles are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
+ */
+bool Warp(const cv::Mat& src, cv::Mat& dst, const cv::Size dst_size,
+          const Transform& transform,
+          const Interpolation interpolation = Interpolation::LINEAR,
+          const BorderMode border_mode = BorderMode::CONSTANT,
+          const uint8_t border_value = 0, const int num_threads = 0);
+
+/** Convert a transformation to a map in the fixed point format of
+ *  FixedPointMap
+ *
+ *  The source coordinates are generated row by row as Warp generates them
+ *  and quantized directly, without floating point maps, for callers that
+ *  keep the map to remap many images.
+ *
+ *  \param[in] transform      destination to source transformation
+ *  \param[in] map_size       size of the destination map
+ *  \param[out] map           converted map
+ *  \param[in] interpolation  interpolation the map will be used with
+ *                            (coordinates are rounded for nearest neighbor)
+ *  \param[in] num_threads    number of worker threads the rows are
+ *                            distributed over (if less than 1, use the
+ *                            number of hardware threads)
+ */
+bool ConvertTransform(const Transform& transform, const cv::Size map_size,
+                      FixedPointMap& map,
+                      const Interpolation interpolation = Interpolation::LINEAR,
+                      const int num_threads = 0);
+}
@@ -0,0 +1,140 @@
+/** Benchmark of remapping throughput over rotation angle
+ *
+ *  \file remap_benchmark.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include <boost/program_options.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "imgs/ipcv/geometric_transformation/Remap.h"
+#include "imgs/ipcv/geometric_transformation/Warp.h"
+
+using namespace std;
+
+namespace po = boost::program_options;
+
+/** Synthetic CV_8UC3 test image of about the requested size */
+static cv::Mat TestImage(const double megapixels) {
+  int cols = static_cast<int>(sqrt(megapixels * 1e6 * 4 / 3));
+  int rows = static_cast<int>(megapixels * 1e6 / cols);
+  cv::Mat image(rows, cols, CV_8UC3);
+  for (int r = 0; r < rows; r++) {
+    uint8_t* ptr = image.ptr<uint8_t>(r);
+    for (int c = 0; c < cols; c++) {
+      for (int chan = 0; chan < 3; chan++) {
+        ptr[3 * c + chan] = static_cast<uint8_t>((r ^ c) + 85 * chan);
+      }
+    }
+  }
+  return image;
+}
+
+/** Fastest of several runs of a callable [s] */
+template <typename Body>
+static double Fastest(const int repeats, Body body) {
+  double best = 0;
+  for (int n = 0; n < repeats; n++) {
+    auto start = chrono::steady_clock::now();
+    body();
+    double elapsed =
+        chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    best = n == 0 ? elapsed : min(best, elapsed);
+  }
+  return best;
+}
+
+int main(int argc, char* argv[]) {
+  double megapixels = 16;
+  double angle_step = 15;
+  int num_threads = 0;
+  int repeats = 3;
+
+  po::options_description options("Options");
+  options.add_options()("help,h", "display this message")(
+      "megapixels,m", po::value<double>(&megapixels),
+      "image size, large enough not to fit in cache [default is 16]")(
+      "angle-step,a", po::value<double>(&angle_step),
+      "step between rotation angles from 0 to 90 [degrees] [default is "
+      "15]")("threads,t", po::value<int>(&num_threads),
+             "number of worker threads [default is all hardware threads]")(
+      "repeats,n", po::value<int>(&repeats),
+      "runs per measurement, the fastest is reported [default is 3]");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, options), vm);
+  po::notify(vm);
+
+  if (vm.count("help") || angle_step <= 0) {
+    cout << "Usage: " << argv[0] << " [options]" << endl;
+    cout << options << endl;
+    return EXIT_SUCCESS;
+  }
+
+  // Rotations about the center with bilinear interpolation; diagonal
+  // angles are where consecutive destination pixels walk the source across
+  // its rows
+  cv::Mat src = TestImage(megapixels);
+  double mp = src.total() / 1e6;
+  cout << setw(8) << "angle" << setw(16) << "Remap [MP/s]" << setw(16)
+       << "fixed [MP/s]" << setw(16) << "Warp [MP/s]" << setw(18)
+       << "cv::remap [MP/s]" << endl;
+  for (double angle = 0; angle <= 90; angle += angle_step) {
+    double radians = angle * M_PI / 180;
+    double cx = src.cols / 2.0;
+    double cy = src.rows / 2.0;
+    cv::Mat map1(src.size(), CV_32FC1);
+    cv::Mat map2(src.size(), CV_32FC1);
+    for (int r = 0; r < src.rows; r++) {
+      for (int c = 0; c < src.cols; c++) {
+        map1.at<float>(r, c) = cos(radians) * (c - cx) -
+                               sin(radians) * (r - cy) + cx;
+        map2.at<float>(r, c) = sin(radians) * (c - cx) +
+                               cos(radians) * (r - cy) + cy;
+      }
+    }
+    ipcv::FixedPointMap fixed;
+    ipcv::ConvertMaps(map1, map2, fixed);
+    ipcv::Transform transform;
+    transform.type = ipcv::TransformType::AFFINE;
+    transform.coefficients = cv::Mat(2, 3, CV_64FC1);
+    cv::Mat& a = transform.coefficients;
+    a.at<double>(0, 0) = cos(radians);
+    a.at<double>(0, 1) = -sin(radians);
+    a.at<double>(0, 2) = cx - cos(radians) * cx + sin(radians) * cy;
+    a.at<double>(1, 0) = sin(radians);
+    a.at<double>(1, 1) = cos(radians);
+    a.at<double>(1, 2) = cy - sin(radians) * cx - cos(radians) * cy;
+    transform.order = 1;
+
+    cv::Mat dst;
+    double remap = Fastest(repeats, [&]() {
+      ipcv::Remap(src, dst, map1, map2, ipcv::Interpolation::LINEAR,
+                  ipcv::BorderMode::CONSTANT, 0, num_threads);
+    });
+    double remap_fixed = Fastest(repeats, [&]() {
+      ipcv::Remap(src, dst, fixed, ipcv::BorderMode::CONSTANT, 0,
+                  num_threads);
+    });
+    double warp = Fastest(repeats, [&]() {
+      ipcv::Warp(src, dst, src.size(), transform, ipcv::Interpolation::LINEAR,
+                 ipcv::BorderMode::CONSTANT, 0, num_threads);
+    });
+    double reference = Fastest(repeats, [&]() {
+      cv::remap(src, dst, map1, map2, cv::INTER_LINEAR);
+    });
+    cout << setw(8) << angle << setw(16) << mp / remap << setw(16)
+         << mp / remap_fixed << setw(16) << mp / warp << setw(18)
+         << mp / reference << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
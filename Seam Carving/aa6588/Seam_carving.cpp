@@ -5,9 +5,14 @@
 
 #include "Seam_carving.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <iostream>
+#include <vector>
 #include <opencv2/imgproc/imgproc.hpp>
 #include "imgs/ipcv/utils/Utils.h"
+#include "imgs/ipcv/utils/BorderMode.h"
 #include "imgs/ipcv/seam_carving/Seam_carving.h"
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
@@ -17,216 +22,243 @@ using namespace cv;
 
 namespace ipcv {
 
+// Number of seams removed
+static const int kNumSeams = 500;
 
-/** Finds and removes seams of image 
+/** Energy of a span of a grayscale row: the mean of the horizontal and
+ *  vertical 3 x 3 Sobel derivatives, normalized, as cv::Sobel and
+ *  cv::addWeighted compute it (borders reflect about the edge pixels)
+ *
+ *  \param[in] gray         grayscale cv::Mat of CV_8UC1
+ *  \param[in] width        number of valid columns of gray
+ *  \param[in] row          row of the span
+ *  \param[in] first        first column of the span
+ *  \param[in] last         last column of the span
+ *  \param[out] energy_row  energy row, written from first to last
+ */
+static void EnergySpan(const Mat& gray, const int width, const int row,
+                       const int first, const int last, double* energy_row) {
+  const uchar* up = gray.ptr<uchar>(
+      BorderIndex(row - 1, gray.rows, BorderMode::REFLECT_101));
+  const uchar* mid = gray.ptr<uchar>(row);
+  const uchar* down = gray.ptr<uchar>(
+      BorderIndex(row + 1, gray.rows, BorderMode::REFLECT_101));
+  for (int col = first; col <= last; col++) {
+    int l = col > 0 ? col - 1 : BorderIndex(-1, width, BorderMode::REFLECT_101);
+    int r = col < width - 1
+                ? col + 1
+                : BorderIndex(width, width, BorderMode::REFLECT_101);
+    double dx = (up[r] - up[l]) + 2 * (mid[r] - mid[l]) + (down[r] - down[l]);
+    double dy = (down[l] + 2 * down[col] + down[r]) -
+                (up[l] + 2 * up[col] + up[r]);
+    energy_row[col] = (0.5 * dx + 0.5 * dy) * (1.0 / 255.0);
+  }
+}
+
+/** Cumulative energy of a pixel from the minimum of its three upper
+ *  neighbors
+ */
+static double CumulativeAt(const double* above, const double energy,
+                           const int col, const int width) {
+  double a = above[max(col - 1, 0)];
+  double b = above[col];
+  double c = above[min(col + 1, width - 1)];
+  return energy + min(a, min(b, c));
+}
+
+/** Finds the vertical seam of least cumulative energy, bottom to top
+ *
+ *  \param[in] cumulative  cumulative energy map of CV_64F
+ *  \param[in] width       number of valid columns
+ *  \param[out] seam       column of the seam in each row
+ */
+static void FindSeam(const Mat& cumulative, const int width,
+                     vector<int>& seam) {
+  int rows = cumulative.rows;
+  const double* last = cumulative.ptr<double>(rows - 1);
+  int min_index = static_cast<int>(min_element(last, last + width) - last);
+  seam[rows - 1] = min_index;
+  for (int i = rows - 2; i >= 0; i--) {
+    const double* row = cumulative.ptr<double>(i);
+    double d = row[max(min_index - 1, 0)];
+    double e = row[min_index];
+    double f = row[min(min_index + 1, width - 1)];
+    double current_min = min(d, min(e, f));
+    int offset = current_min == f ? 1 : current_min == e ? 0 : -1;
+    min_index = min(max(min_index + offset, 0), width - 1);
+    seam[i] = min_index;
+  }
+}
+
+/** Removes one pixel per row at the seam, shifting the rest of each row
+ *  left over it
+ *
+ *  \param[in,out] buffer  cv::Mat whose first width columns are valid
+ *  \param[in] width       number of valid columns before the removal
+ *  \param[in] seam        column removed from each row
+ */
+static void RemoveSeam(Mat& buffer, const int width, const vector<int>& seam) {
+  size_t elem_size = buffer.elemSize();
+  for (int r = 0; r < buffer.rows; r++) {
+    uchar* row = buffer.ptr<uchar>(r);
+    memmove(row + seam[r] * elem_size, row + (seam[r] + 1) * elem_size,
+            (width - seam[r] - 1) * elem_size);
+  }
+}
+
+/** Columns of each row whose energy a removed seam changed
+ *
+ *  A pixel keeps its energy unless its 3 x 3 neighborhood straddles the
+ *  seam, so only the columns between the seam positions of the row and its
+ *  two neighbors (plus the neighborhood radius) change.
+ *
+ *  \param[in] seam    column removed from each row
+ *  \param[in] width   number of valid columns after the removal
+ *  \param[out] first  first changed column of each row
+ *  \param[out] last   last changed column of each row
+ */
+static void SeamBand(const vector<int>& seam, const int width,
+                     vector<int>& first, vector<int>& last) {
+  int rows = static_cast<int>(seam.size());
+  for (int r = 0; r < rows; r++) {
+    int above = seam[BorderIndex(r - 1, rows, BorderMode::REFLECT_101)];
+    int below = seam[BorderIndex(r + 1, rows, BorderMode::REFLECT_101)];
+    int lo = min(seam[r], min(above, below));
+    int hi = max(seam[r], max(above, below));
+    first[r] = max(lo - 2, 0);
+    last[r] = min(hi + 1, width - 1);
+  }
+}
+
+/** Updates the cumulative energy map after a seam removal
+ *
+ *  Row by row, only the pixels in the changed energy band and next to the
+ *  pixels that changed in the row above are recomputed; the changes die out
+ *  a few rows below where the seam disturbed the minima, so the update
+ *  costs about the band rather than the whole map.
+ *
+ *  \param[in] energy          energy map of CV_64F
+ *  \param[in,out] cumulative  cumulative energy map of CV_64F, shifted
+ *                             over the removed seam
+ *  \param[in] width           number of valid columns
+ *  \param[in] first           first changed energy column of each row
+ *  \param[in] last            last changed energy column of each row
+ */
+static void UpdateCumulative(const Mat& energy, Mat& cumulative,
+                             const int width, const vector<int>& first,
+                             const vector<int>& last) {
+  // Changed columns of the previous row (empty if lo > hi)
+  int changed_lo = INT_MAX;
+  int changed_hi = -1;
+  for (int r = 0; r < energy.rows; r++) {
+    const double* energy_row = energy.ptr<double>(r);
+    double* row = cumulative.ptr<double>(r);
+    int lo = first[r];
+    int hi = last[r];
+    if (changed_lo <= changed_hi) {
+      lo = min(lo, max(changed_lo - 1, 0));
+      hi = max(hi, min(changed_hi + 1, width - 1));
+    }
+    changed_lo = INT_MAX;
+    changed_hi = -1;
+    const double* above = r > 0 ? cumulative.ptr<double>(r - 1) : nullptr;
+    for (int col = lo; col <= hi; col++) {
+      double value = r > 0 ? CumulativeAt(above, energy_row[col], col, width)
+                           : energy_row[col];
+      if (value != row[col]) {
+        row[col] = value;
+        changed_lo = min(changed_lo, col);
+        changed_hi = col;
+      }
+    }
+  }
+}
+
+/** Finds and removes seams of image
  *  \param[in] src          source cv::Mat of CV_8UC1
  *  \param[out] resized     new resized image
  *  \param[out] seam        cv::Mat with seam locations
  */
 
 void Seam(cv::Mat src, cv::Mat dst, cv::Mat energy_image, bool seam_direction){
+dst = src.clone();
+
+// The image, energy and cumulative energy are kept from one seam to the
+// next in buffers with a logical width; seams are removed in place and the
+// energy only updated around them.  Horizontal seams are found and removed
+// as vertical seams of the transposed image, so both directions shift
+// along contiguous rows.
 cv::Mat image;
+if (seam_direction == true) {
+    image = dst;
+} else {
+    transpose(dst, image);
+}
 cv::Mat image_gray;
-dst = src.clone();
+cvtColor(image, image_gray, COLOR_BGR2GRAY);
+int rows = image_gray.rows;
+int width = image_gray.cols;
+Mat energy(rows, width, CV_64F);
+Mat energy_map(rows, width, CV_64F);
+for (int r = 0; r < rows; r++) {
+    EnergySpan(image_gray, width, r, 0, width - 1, energy.ptr<double>(r));
+}
+energy.row(0).copyTo(energy_map.row(0));
+for (int r = 1; r < rows; r++) {
+    const double* above = energy_map.ptr<double>(r - 1);
+    const double* energy_row = energy.ptr<double>(r);
+    double* row = energy_map.ptr<double>(r);
+    for (int col = 0; col < width; col++) {
+        row[col] = CumulativeAt(above, energy_row[col], col, width);
+    }
+}
+
+vector<int> seam(rows);
+vector<int> first(rows);
+vector<int> last(rows);
+int num_seams = min(kNumSeams, width - 1);
 
 //i = number of column/rows taken out
-for (int i = 0; i < 500; i++){
-
-cvtColor(dst,image_gray,COLOR_BGR2GRAY);
-cv::Mat gradient;
-
-//calculate gradient (energy matrix)
-    Mat dx;
-    Mat dy;
-    Sobel(image_gray, dx, CV_64F, 1, 0);
-    Sobel(image_gray, dy, CV_64F, 0, 1);
-    // add gradients
-    addWeighted( dx, 0.5, dy, 0.5, 0, gradient );
-    // convert and normalize
-    gradient.convertTo(energy_image, CV_64F, 1.0/255.0);
-
-double a,b,c;
-    
-    // get the numbers of rows and columns in the image
-    int rowsize = energy_image.rows;
-    int colsize = energy_image.cols;
-    
-    // initialize the map with zeros
-    Mat energy_map = Mat_<double>::zeros(rowsize,colsize);
-    
-    // copy the first row or column depending on direction
-    if (seam_direction == true) energy_image.row(0).copyTo(energy_map.row(0));
-    else if (seam_direction == false) energy_image.col(0).copyTo(energy_map.col(0));
-    
-    // take the minimum of the three neighbors and add to total energy
-    if (seam_direction == true) //vertical
-{
-        for (int row = 1; row < rowsize; row++) {
-            for (int col = 0; col < colsize; col++) {
-                a = energy_map.at<double>(row - 1, max(col - 1, 0));
-                b = energy_map.at<double>(row - 1, col);
-                c = energy_map.at<double>(row - 1, min(col + 1, colsize - 1));
-                
-                energy_map.at<double>(row, col) = energy_image.at<double>(row, col) + min(a, min(b, c));
-            }
-        }
-    }
-    else if (seam_direction == false) //horiztonal
-{
-        for (int col = 1; col < colsize; col++) {
-            for (int row = 0; row < rowsize; row++) {
-                a = energy_map.at<double>(max(row - 1, 0), col - 1);
-                b = energy_map.at<double>(row, col - 1);
-                c = energy_map.at<double>(min(row + 1, rowsize - 1), col - 1);
-                
-                energy_map.at<double>(row, col) = energy_image.at<double>(row, col) + min(a, min(b, c));
-            }
-        }
-    }
-    
-    
-//find optimal seams
-double d,e,f;
-    int offset = 0;
-    vector<int> seam;
-    //double min_val, max_val;
-    Point min_loc, max_loc;
-    
-    if (seam_direction == true) {
-        // copy the data from the last row of the energy map
-        Mat row = energy_map.row(rowsize - 1);
-    
-        // get min and max values and locations
-        minMaxLoc(row, NULL, NULL, &min_loc, &max_loc);
-        
-        // initialize the seam vector
-        seam.resize(rowsize);
-        int min_index = min_loc.x;
-        int current_min = 0;
-        seam[rowsize - 1] = min_index;
-   //bottom to top
-        for (int i = rowsize - 2; i >= 0; i--) {
-            d = energy_map.at<double>(i, min_index - 1);
-            e = energy_map.at<double>(i, min_index);
-            f = energy_map.at<double>(i, min_index + 1);
-            current_min = min(d,min(e,f));
-            if (current_min == f) {
-                offset = 1;
-            }
-            else if (current_min == e) {
-                offset = 0;
-            }
-            else if (current_min == d) {
-                offset = -1;
-            }
-            
-            min_index += offset;
-            min_index = min(max(min_index, 0), colsize - 1); // take care of edge cases
-            seam[i] = min_index;
-        }
-    }
-    
-    else if (seam_direction == false) {
-        // copy the data from the last column of the cumulative energy map
-        Mat col = energy_map.col(colsize - 1);
-        
-        // get min and max values and locations
-        minMaxLoc(col, NULL,NULL, &min_loc, &max_loc);
-        
-        // initialize the path vector
-        seam.resize(colsize);
-        int min_index = min_loc.y;
-        seam[colsize - 1] = min_index;
-       int current_min =0; 
-        // starting from the right, look at the three adjacent pixels to the left of current pixel, choose the minimum of those and add to the path
-        for (int i = colsize - 2; i >= 0; i--) {
-            d = energy_map.at<double>(min_index - 1, i);
-            e = energy_map.at<double>(min_index, i);
-            f = energy_map.at<double>(min_index + 1, i);
-            //right
-            if (current_min == f) {
-                offset = 1;
-            }
-            //middle
-            else if (current_min == e) {
-                offset = 0;
-            }
-            //left
-            else if (current_min == d) {
-                offset = -1;
-            }
-            
-            min_index += offset;
-           // min_index = min(max(min_index, 0), rowsize - 1); // take care of edge cases
-            seam[i] = min_index;
-        }
-    }
+for (int i = 0; i < num_seams; i++){
+    //find optimal seam
+    FindSeam(energy_map, width, seam);
 
-Mat dummy(1, 1, CV_8UC3, Vec3b(0, 0, 0));
-    if (seam_direction == true) { // reduce the width
-        for (int i = 0; i < rowsize; i++) {
-            // take all pixels to the left and right of marked pixel and store them 
-            Mat new_row;
-            Mat lower = dst.rowRange(i, i + 1).colRange(0, seam[i]);
-            Mat upper = dst.rowRange(i, i + 1).colRange(seam[i] + 1, colsize);
-            
-            if (!lower.empty() && !upper.empty()) {
-                hconcat(lower, upper, new_row);
-                hconcat(new_row, dummy, new_row);
-            }
-            else {
-                if (lower.empty()) {
-                    hconcat(upper, dummy, new_row);
-                }
-                else if (upper.empty()) {
-                    hconcat(lower, dummy, new_row);
-                }
-            }
-            new_row.copyTo(dst.row(i));
-        }
-        // clip the last col of image
-        dst = dst.colRange(0, colsize - 1);
-    }
-    else if (seam_direction == false) { // reduce the height
-        for (int i = 0; i < colsize; i++) {
-            // take all pixels to the top and bottom of marked pixel and store
-            Mat new_col;
-            Mat lower = dst.colRange(i, i + 1).rowRange(0, seam[i]);
-            Mat upper = dst.colRange(i, i + 1).rowRange(seam[i] + 1, rowsize);
-            
-            if (!lower.empty() && !upper.empty()) {
-                vconcat(lower, upper, new_col);
-                vconcat(new_col, dummy, new_col);
-            }
-            else {
-                if (lower.empty()) {
-                    vconcat(upper, dummy, new_col);
-                }
-                else if (upper.empty()) {
-                    vconcat(lower, dummy, new_col);
-                }
-            }
-            // take the newly formed column and place it into the original image
-            new_col.copyTo(dst.col(i));
-        }
-        // clip the bottom row
-        dst = dst.rowRange(0, rowsize - 1);
+    // remove the seam from the image, the grayscale values of the remaining
+    // pixels do not change, so the working buffers are shifted over the seam
+    // and the energy is only recomputed in the band around it
+    RemoveSeam(image, width, seam);
+    RemoveSeam(image_gray, width, seam);
+    RemoveSeam(energy, width, seam);
+    RemoveSeam(energy_map, width, seam);
+    width--;
+    SeamBand(seam, width, first, last);
+    for (int r = 0; r < rows; r++) {
+        EnergySpan(image_gray, width, r, first[r], last[r],
+                   energy.ptr<double>(r));
     }
+    UpdateCumulative(energy, energy_map, width, first, last);
+}
 
- if (seam_direction == true) {
-        for (int i = 0; i < energy_image.rows; i++) {
-            energy_image.at<double>(i,seam[i]) = 1;
-        }
-    }
-    else if (seam_direction == false) {
-        for (int i = 0; i < energy_image.cols; i++) {
-            energy_image.at<double>(seam[i],i) = 1;
-        }
-    }
+// the resized image is the valid part of the buffer
+if (seam_direction == true) {
+    dst = image.colRange(0, width);
+} else {
+    transpose(image.colRange(0, width), dst);
+}
+
+// show the energy of the result, with the last seam marked
+energy_image = energy.colRange(0, width).clone();
+for (int r = 0; r < rows; r++) {
+    energy_image.at<double>(r, min(seam[r], width - 1)) = 1;
+}
+if (seam_direction == false) {
+    cv::Mat transposed;
+    transpose(energy_image, transposed);
+    energy_image = transposed;
+}
 
         imshow("Reduced Image", dst);
     imshow ("energy", energy_image);
 cv::waitKey(0);
 }
 }
-}
@@ -8,19 +8,256 @@
 
 #include "Filter2D.h"
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
+
+#include "Filter2DRows.h"
+#include "RowRing.h"
+#include "imgs/ipcv/utils/Parallel.h"
 
 using namespace std;
 
 namespace ipcv {
 
+// Kernel area above which AUTO correlates non-separable kernels in the
+// frequency domain (about 11x11)
+static const int kFftMinKernelArea = 121;
+
+// Output tile size [pixels]; a tile and the source rows it reads stay
+// resident in the per-core cache
+static const int kTileRows = 64;
+static const int kTileCols = 256;
+
+/** Calls body with a value of the sample type of an OpenCV depth
+ *
+ *  \param[in] depth  CV_8U, CV_16U, CV_16S, CV_32F or CV_64F
+ *  \param[in] body   generic callable taking the sample value
+ *
+ *  \return           false if the depth is not supported
+ */
+template <typename Body>
+static bool WithSampleType(const int depth, Body body) {
+  switch (depth) {
+  case CV_8U:
+    body(uint8_t());
+    return true;
+  case CV_16U:
+    body(uint16_t());
+    return true;
+  case CV_16S:
+    body(int16_t());
+    return true;
+  case CV_32F:
+    body(float());
+    return true;
+  case CV_64F:
+    body(double());
+    return true;
+  }
+  return false;
+}
+
+/** Whether a depth is one the spatial paths are instantiated for */
+static bool SupportedDepth(const int depth) {
+  return WithSampleType(depth, [](auto) {});
+}
+
+/** Runs body over the tiles covering an image, distributed over a pool of
+ *  worker threads
+ *
+ *  Every tile is computed independently and identically, so the result
+ *  does not depend on the number of threads.
+ */
+template <typename Body>
+static void ForEachTile(const cv::Size size, const int num_threads,
+                        Body body) {
+  int tiles_x = (size.width + kTileCols - 1) / kTileCols;
+  int tiles_y = (size.height + kTileRows - 1) / kTileRows;
+  ParallelFor(tiles_x * tiles_y, num_threads, [&](int begin, int end) {
+    for (int idx = begin; idx < end; idx++) {
+      int x = (idx % tiles_x) * kTileCols;
+      int y = (idx / tiles_x) * kTileRows;
+      body(cv::Rect(x, y, min(kTileCols, size.width - x),
+                    min(kTileRows, size.height - y)));
+    }
+  });
+}
+
+/** Correlates one tile of an image with a full 2D kernel of kh x kw taps,
+ *  one destination row at a time
+ *
+ *  \param[in] row_filter  callable filtering a row from kh extended source
+ *                         rows into tile.width destination pixels
+ *  \param[in] tile        region of dst to compute
+ */
+template <typename RowFilter>
+static void FilterTile(const cv::Mat &src, cv::Mat &dst, const int kh,
+                       const int kw, const cv::Point anchor,
+                       const BorderMode border_mode,
+                       const uint8_t border_value, const cv::Rect &tile,
+                       RowFilter row_filter) {
+  RowRing ring(src, tile.x - anchor.x, tile.width + kw - 1, kh, border_mode,
+               border_value);
+  vector<const uint8_t *> rows(kh);
+  for (int r = tile.y; r < tile.y + tile.height; r++) {
+    for (int i = 0; i < kh; i++) {
+      rows[i] = ring.Row(r - anchor.y + i);
+    }
+    row_filter(rows.data(), dst.ptr<uint8_t>(r) + tile.x * dst.elemSize());
+  }
+}
+
+/** Correlates one tile of an image with a KH x KW kernel whose size is known
+ *  at compile time
+ *
+ *  \param[in] kernel  single-channel CV_32F kernel of KH x KW
+ *  \param[in] tile    region of dst to compute
+ */
+template <int KH, int KW, typename T, typename D>
+static void FilterSmallTile(const cv::Mat &src, cv::Mat &dst,
+                            const cv::Mat &kernel, const cv::Point anchor,
+                            const int delta, const BorderMode border_mode,
+                            const uint8_t border_value, const cv::Rect &tile) {
+  float weights[KH][KW];
+  for (int i = 0; i < KH; i++) {
+    for (int j = 0; j < KW; j++) {
+      weights[i][j] = kernel.at<float>(i, j);
+    }
+  }
+  int cn = src.channels();
+  int n = cn * tile.width;
+  FilterTile(src, dst, KH, KW, anchor, border_mode, border_value, tile,
+             [&](const uint8_t *const *rows, uint8_t *out) {
+               SmallKernelRow<KH, KW, T, D>(rows, weights, cn, delta,
+                                            reinterpret_cast<D *>(out), n);
+             });
+}
+
+/** Correlates one tile of an image with a separable kernel as a horizontal
+ *  pass followed by a vertical pass (O(kx.size() + ky.size()) per pixel)
+ *
+ *  \param[in] tile  region of dst to compute
+ */
+template <typename T, typename D>
+static void FilterSeparable(const cv::Mat &src, cv::Mat &dst,
+                            const vector<float> &ky, const vector<float> &kx,
+                            const cv::Point anchor, const int delta,
+                            const BorderMode border_mode,
+                            const uint8_t border_value, const cv::Rect &tile) {
+  int kh = ky.size();
+  int kw = kx.size();
+  int cn = src.channels();
+  int width = cn * tile.width;
+
+  // Horizontal pass over the source rows the tile depends on; each row is
+  // read once, so the ring only needs a single slot
+  int first_row = tile.y - anchor.y;
+  RowRing ring(src, tile.x - anchor.x, tile.width + kw - 1, 1, border_mode,
+               border_value);
+  cv::Mat rows_filtered(tile.height + kh - 1, width, CV_32FC1);
+  for (int t = 0; t < rows_filtered.rows; t++) {
+    HorizontalRow<T>(ring.Row(first_row + t), kx, cn,
+                     rows_filtered.ptr<float>(t), width);
+  }
+
+  // Vertical pass
+  vector<const float *> rows(kh);
+  vector<float> total(width);
+  for (int r = 0; r < tile.height; r++) {
+    for (int i = 0; i < kh; i++) {
+      rows[i] = rows_filtered.ptr<float>(r + i);
+    }
+    VerticalRow(rows.data(), ky, delta, dst.ptr<D>(tile.y + r) + cn * tile.x,
+                width, total.data());
+  }
+}
+
+/** Correlates one tile of an image along the spatial path chosen for the
+ *  kernel, with T source samples and D destination samples
+ *
+ *  \param[in] tile  region of dst to compute
+ */
+template <typename T, typename D>
+static void FilterSpatialTile(const cv::Mat &src, cv::Mat &dst,
+                              const SpatialKernel &prepared,
+                              const cv::Point anchor, const int delta,
+                              const BorderMode border_mode,
+                              const uint8_t border_value,
+                              const cv::Rect &tile) {
+  const cv::Mat &kernel = prepared.kernel;
+  int cn = src.channels();
+  int n = cn * tile.width;
+
+  if (prepared.path == SpatialPath::SEPARABLE) {
+    FilterSeparable<T, D>(src, dst, prepared.ky, prepared.kx, anchor, delta,
+                          border_mode, border_value, tile);
+  } else if (prepared.path == SpatialPath::FIXED_POINT) {
+    // Only chosen for 8-bit sources and destinations
+    FilterTile(src, dst, kernel.rows, kernel.cols, anchor, border_mode,
+               border_value, tile,
+               [&](const uint8_t *const *rows, uint8_t *out) {
+                 FixedPointRow(rows, prepared.fixed, cn, delta, out, n);
+               });
+  } else if (kernel.rows == 3 && kernel.cols == 3) {
+    FilterSmallTile<3, 3, T, D>(src, dst, kernel, anchor, delta, border_mode,
+                                border_value, tile);
+  } else if (kernel.rows == 5 && kernel.cols == 5) {
+    FilterSmallTile<5, 5, T, D>(src, dst, kernel, anchor, delta, border_mode,
+                                border_value, tile);
+  } else {
+    FilterTile(src, dst, kernel.rows, kernel.cols, anchor, border_mode,
+               border_value, tile,
+               [&](const uint8_t *const *rows, uint8_t *out) {
+                 DirectRow<T, D>(rows, kernel, cn, delta,
+                                 reinterpret_cast<D *>(out), n);
+               });
+  }
+}
+
+/** Checks the source and destination depths and creates the destination
+ *
+ *  \param[in] ddepth  desired depth of the destination image (if negative,
+ *                     the depth of src)
+ *
+ *  \return            false if either depth is not supported
+ */
+static bool CreateDestination(const cv::Mat &src, cv::Mat &dst,
+                              const int ddepth) {
+  int out_depth = ddepth < 0 ? src.depth() : CV_MAT_DEPTH(ddepth);
+  if (!SupportedDepth(src.depth()) || !SupportedDepth(out_depth)) {
+    cerr << "*** ERROR *** ";
+    cerr << "Filter2D supports CV_8U, CV_16U, CV_16S, CV_32F and CV_64F "
+            "sources and destinations"
+         << endl;
+    return false;
+  }
+  dst.create(src.size(), CV_MAKETYPE(out_depth, src.channels()));
+  return true;
+}
+
+/** Resolves the default anchor to the center of the kernel */
+static cv::Point KernelCenter(const cv::Mat &kernel, const cv::Point anchor) {
+  cv::Point center = anchor;
+  if (center.x < 0) {
+    center.x = kernel.cols / 2;
+  }
+  if (center.y < 0) {
+    center.y = kernel.rows / 2;
+  }
+  return center;
+}
+
 /** Correlates an image with the provided kernel
  *
- *  \param[in] src          source cv::Mat of CV_8UC3
- *  \param[out] dst         destination cv::Mat of ddepth type
- *  \param[in] ddepth       desired depth of the destination image
+ *  \param[in] src          source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                          or CV_64F with any number of channels
+ *  \param[out] dst         destination cv::Mat with the channels of src
+ *  \param[in] ddepth       desired depth of the destination image (CV_8U,
+ *                          CV_16U, CV_16S, CV_32F or CV_64F; if negative,
+ *                          the depth of src)
  *  \param[in] kernel       convolution kernel (or rather a correlation
- *                          kernel), a single-channel floating point matrix
+ *                          kernel), a single-channel matrix of any depth
  *  \param[in] anchor       anchor of the kernel that indicates the relative
  *                          position of a filtered point within the kernel;
  *                          the anchor should lie within the kernel; default
@@ -30,40 +267,136 @@ namespace ipcv {
  *                          before storing them in dst
  *  \param[in] border_mode  pixel extrapolation method
  *  \param[in] border_value value to use for constant border mode
+ *  \param[in] method       filtering method; AUTO correlates large
+ *                          non-separable kernels in the frequency domain and
+ *                          uses fixed point for the rest of the 8-bit to
+ *                          8-bit cases when the kernel quantizes to within
+ *                          half a digital count
+ *  \param[in] num_threads  number of worker threads the spatial tiles are
+ *                          distributed over (if less than 1, use the number
+ *                          of hardware threads)
  */
 bool Filter2D(const cv::Mat &src, cv::Mat &dst, const int ddepth,
               cv::Mat &kernel, const cv::Point anchor, const int delta,
-              const BorderMode border_mode, uint8_t border_value) {
+              const BorderMode border_mode, uint8_t border_value,
+              const FilterMethod method, const int num_threads) {
+  if (method == FilterMethod::FFT) {
+    return Filter2DFFT(src, dst, ddepth, kernel, anchor, delta, border_mode,
+                       border_value);
+  }
 
   // Create destination image
-  dst.create(src.size(), ddepth);
-
-  // find the center of the kernel
-  float a = (kernel.rows - 1) / 2;
-  float b = (kernel.cols - 1) / 2;
-
-  // Iterate through color channels
-  for (int chan = 0; chan < 3; chan++) {
-    // Iterate through source image rows and columns
-    for (int x = a; x < src.rows - a; x++) {
-      cv::Vec3b *ptr = dst.ptr<cv::Vec3b>(x);
-      for (int y = b; y < src.cols - b; y++) {
-
-        int total = 0;
-        // Iterate through kernel rows and columns
-        for (int t = 0; t < kernel.cols; t++) {
-          float *ptr1 = kernel.ptr<float>(t);
-          for (int s = 0; s < kernel.rows; s++) {
-            // sum the product of the weights in kernels by DCs in source image
-            total += ptr1[s] * src.at<cv::Vec3b>(x + s, y + t)[chan];
-          }
-        }
-        // insert product in destination image
-        total = clamp(total, 0, 255);
-        ptr[y][chan] = total + delta;
-      }
-    }
+  if (!CreateDestination(src, dst, ddepth)) {
+    return false;
+  }
+  cv::Point center = KernelCenter(kernel, anchor);
+
+  // Integer and double kernels are applied with float weights
+  cv::Mat kernel_f;
+  kernel.convertTo(kernel_f, CV_32F);
+
+  // Large kernels that do not separate are cheaper in the frequency domain
+  bool eight_bit = src.depth() == CV_8U && dst.depth() == CV_8U;
+  SpatialKernel prepared = PrepareKernel(kernel_f, method, eight_bit);
+  if (method == FilterMethod::AUTO && prepared.path != SpatialPath::SEPARABLE &&
+      kernel.rows * kernel.cols > kFftMinKernelArea) {
+    return Filter2DFFT(src, dst, ddepth, kernel, anchor, delta, border_mode,
+                       border_value);
   }
+
+  ForEachTile(src.size(), num_threads, [&](const cv::Rect &tile) {
+    WithSampleType(src.depth(), [&](auto src_sample) {
+      WithSampleType(dst.depth(), [&](auto dst_sample) {
+        FilterSpatialTile<decltype(src_sample), decltype(dst_sample)>(
+            src, dst, prepared, center, delta, border_mode, border_value,
+            tile);
+      });
+    });
+  });
+
   return true;
 }
+
+/** Correlates an image with a kernel whose size, KH x KW, is fixed at
+ *  compile time
+ *
+ *  \param[in] src          source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                          or CV_64F with any number of channels
+ *  \param[out] dst         destination cv::Mat with the channels of src
+ *  \param[in] ddepth       desired depth of the destination image (if
+ *                          negative, the depth of src)
+ *  \param[in] kernel       KH x KW correlation kernel, a single-channel
+ *                          matrix of any depth
+ *  \param[in] anchor       anchor of the kernel (default is the center)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *                          before storing them in dst
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ *  \param[in] num_threads  number of worker threads (if less than 1, use the
+ *                          number of hardware threads)
+ */
+template <int KH, int KW>
+bool Filter2D(const cv::Mat &src, cv::Mat &dst, const int ddepth,
+              const cv::Mat &kernel, const cv::Point anchor, const int delta,
+              const BorderMode border_mode, uint8_t border_value,
+              const int num_threads) {
+  if (kernel.rows != KH || kernel.cols != KW) {
+    cerr << "*** ERROR *** ";
+    cerr << "Filter2D<" << KH << ", " << KW << "> was given a "
+         << kernel.rows << "x" << kernel.cols << " kernel" << endl;
+    return false;
+  }
+  if (!CreateDestination(src, dst, ddepth)) {
+    return false;
+  }
+  cv::Point center = KernelCenter(kernel, anchor);
+
+  cv::Mat kernel_f;
+  kernel.convertTo(kernel_f, CV_32F);
+
+  ForEachTile(src.size(), num_threads, [&](const cv::Rect &tile) {
+    WithSampleType(src.depth(), [&](auto src_sample) {
+      WithSampleType(dst.depth(), [&](auto dst_sample) {
+        FilterSmallTile<KH, KW, decltype(src_sample), decltype(dst_sample)>(
+            src, dst, kernel_f, center, delta, border_mode, border_value,
+            tile);
+      });
+    });
+  });
+
+  return true;
+}
+
+template bool Filter2D<3, 3>(const cv::Mat &, cv::Mat &, const int,
+                             const cv::Mat &, const cv::Point, const int,
+                             const BorderMode, uint8_t, const int);
+template bool Filter2D<5, 5>(const cv::Mat &, cv::Mat &, const int,
+                             const cv::Mat &, const cv::Point, const int,
+                             const BorderMode, uint8_t, const int);
+
+/** Reports how far the fixed point path deviates from floating point
+ *
+ *  \param[in] src          source cv::Mat of CV_8U
+ *  \param[in] kernel       correlation kernel, a single-channel matrix
+ *  \param[in] anchor       anchor of the kernel (default is the center)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ *
+ *  \return                 maximum absolute difference [digital counts]
+ *                          between the FIXED_POINT and SPATIAL results
+ */
+double Filter2DFixedPointDeviation(const cv::Mat &src, cv::Mat &kernel,
+                                   const cv::Point anchor, const int delta,
+                                   const BorderMode border_mode,
+                                   uint8_t border_value) {
+  cv::Mat fixed_dst;
+  cv::Mat float_dst;
+  Filter2D(src, fixed_dst, src.type(), kernel, anchor, delta, border_mode,
+           border_value, FilterMethod::FIXED_POINT);
+  Filter2D(src, float_dst, src.type(), kernel, anchor, delta, border_mode,
+           border_value, FilterMethod::SPATIAL);
+
+  return cv::norm(fixed_dst, float_dst, cv::NORM_INF);
+}
 } // namespace ipcv
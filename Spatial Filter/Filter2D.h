@@ -7,23 +7,41 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include <opencv2/core.hpp>
 
+#include "imgs/ipcv/utils/BorderMode.h"
+
 namespace ipcv {
 
-// Available border modes
-enum class BorderMode {
-  CONSTANT,  // Use background color
-  REPLICATE  // Replicate border pixels
+// Available filtering methods
+enum class FilterMethod {
+  AUTO,        // Choose from the kernel size, separability and precision
+  SPATIAL,     // Correlate in the spatial domain (two passes if separable)
+  FFT,         // Multiply spectra in the frequency domain
+  FIXED_POINT  // Correlate with a 16-bit fixed point kernel (SIMD)
 };
 
+// Callback filling source row `row` (width interleaved pixels) into `data`;
+// returning false aborts the stream
+typedef std::function<bool(const int row, uint8_t* data)> RowSource;
+
+// Callback receiving filtered row `row` from `data`; returning false aborts
+// the stream
+typedef std::function<bool(const int row, const uint8_t* data)> RowSink;
+
 /** Correlates an image with the provided kernel
  *
- *  \param[in] src          source cv::Mat of CV_8UC3
- *  \param[out] dst         destination cv::Mat of ddepth type
- *  \param[in] ddepth       desired depth of the destination image
+ *  \param[in] src          source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                          or CV_64F with any number of channels
+ *  \param[out] dst         destination cv::Mat with the channels of src
+ *  \param[in] ddepth       desired depth of the destination image (CV_8U,
+ *                          CV_16U, CV_16S, CV_32F or CV_64F; if negative,
+ *                          the depth of src)
  *  \param[in] kernel       convolution kernel (or rather a correlation
- *                          kernel), a single-channel floating point matrix
+ *                          kernel), a single-channel matrix of any depth
  *  \param[in] anchor       anchor of the kernel that indicates the relative
  *                          position of a filtered point within the kernel;
  *                          the anchor should lie within the kernel; default
@@ -33,10 +51,154 @@ enum class BorderMode {
  *                          before storing them in dst
  *  \param[in] border_mode  pixel extrapolation method
  *  \param[in] border_value value to use for constant border mode
+ *  \param[in] method       filtering method; AUTO correlates large
+ *                          non-separable kernels in the frequency domain and
+ *                          uses fixed point for the rest of the 8-bit to
+ *                          8-bit cases when the kernel quantizes to within
+ *                          half a digital count; 3x3 and 5x5 kernels on the
+ *                          floating point path use the Filter2D<KH, KW>
+ *                          row kernels
+ *  \param[in] num_threads  number of worker threads the spatial tiles are
+ *                          distributed over (if less than 1, use the number
+ *                          of hardware threads); the result does not depend
+ *                          on the thread count
  */
 bool Filter2D(const cv::Mat& src, cv::Mat& dst, const int ddepth,
               cv::Mat& kernel, const cv::Point anchor = cv::Point(-1, -1),
               const int delta = 0,
               const BorderMode border_mode = BorderMode::REPLICATE,
-              uint8_t border_value = 0);
+              uint8_t border_value = 0,
+              const FilterMethod method = FilterMethod::AUTO,
+              const int num_threads = 0);
+
+/** Correlates an image with a kernel whose size, KH x KW, is fixed at
+ *  compile time
+ *
+ *  The tap loops are fully unrolled and the weights stay in registers.  The
+ *  result is identical to Filter2D with the SPATIAL method.  Instantiated
+ *  for 3x3 and 5x5 kernels.
+ *
+ *  \param[in] src          source cv::Mat of CV_8U, CV_16U, CV_16S, CV_32F
+ *                          or CV_64F with any number of channels
+ *  \param[out] dst         destination cv::Mat with the channels of src
+ *  \param[in] ddepth       desired depth of the destination image (if
+ *                          negative, the depth of src)
+ *  \param[in] kernel       KH x KW correlation kernel, a single-channel
+ *                          matrix of any depth
+ *  \param[in] anchor       anchor of the kernel (default is the center)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *                          before storing them in dst
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ *  \param[in] num_threads  number of worker threads (if less than 1, use the
+ *                          number of hardware threads)
+ */
+template <int KH, int KW>
+bool Filter2D(const cv::Mat& src, cv::Mat& dst, const int ddepth,
+              const cv::Mat& kernel, const cv::Point anchor = cv::Point(-1, -1),
+              const int delta = 0,
+              const BorderMode border_mode = BorderMode::REPLICATE,
+              uint8_t border_value = 0, const int num_threads = 0);
+
+extern template bool Filter2D<3, 3>(const cv::Mat&, cv::Mat&, const int,
+                                    const cv::Mat&, const cv::Point, const int,
+                                    const BorderMode, uint8_t, const int);
+extern template bool Filter2D<5, 5>(const cv::Mat&, cv::Mat&, const int,
+                                    const cv::Mat&, const cv::Point, const int,
+                                    const BorderMode, uint8_t, const int);
+
+/** Reports how far the fixed point path deviates from floating point
+ *
+ *  \param[in] src          source cv::Mat of CV_8U
+ *  \param[in] kernel       correlation kernel, a single-channel matrix
+ *  \param[in] anchor       anchor of the kernel (default is the center)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ *
+ *  \return                 maximum absolute difference [digital counts]
+ *                          between the FIXED_POINT and SPATIAL results
+ */
+double Filter2DFixedPointDeviation(
+    const cv::Mat& src, cv::Mat& kernel,
+    const cv::Point anchor = cv::Point(-1, -1), const int delta = 0,
+    const BorderMode border_mode = BorderMode::REPLICATE,
+    uint8_t border_value = 0);
+
+/** Correlates an image with the provided kernel by multiplying the spectra
+ *  of the border extended image and the zero padded kernel
+ *
+ *  \param[in] src          source cv::Mat of any depth and number of
+ *                          channels
+ *  \param[out] dst         destination cv::Mat with the channels of src
+ *  \param[in] ddepth       desired depth of the destination image (if
+ *                          negative, the depth of src)
+ *  \param[in] kernel       correlation kernel, a single-channel matrix of
+ *                          any depth
+ *  \param[in] anchor       anchor of the kernel (default is the center)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *                          before storing them in dst
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ */
+bool Filter2DFFT(const cv::Mat& src, cv::Mat& dst, const int ddepth,
+                 const cv::Mat& kernel,
+                 const cv::Point anchor = cv::Point(-1, -1),
+                 const int delta = 0,
+                 const BorderMode border_mode = BorderMode::REPLICATE,
+                 uint8_t border_value = 0);
+
+/** Correlates an image with every kernel of a filter bank in a single pass
+ *
+ *  Each source neighborhood is loaded once and every kernel is evaluated
+ *  against it, so source memory traffic does not grow with the number of
+ *  kernels.  Kernels may differ in size; each is anchored at its center.
+ *
+ *  \param[in] src          source cv::Mat of CV_8UC1 or CV_8UC3
+ *  \param[in] kernels      correlation kernels, single-channel floating point
+ *                          matrices
+ *  \param[out] dsts        one destination cv::Mat per kernel, with the
+ *                          channels of src and the ddepth depth
+ *  \param[in] ddepth       desired depth of the destination images (CV_8U or
+ *                          CV_32F)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *                          before storing them in dsts
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ *  \param[in] num_threads  number of worker threads (if less than 1, use the
+ *                          number of hardware threads)
+ */
+bool Filter2DBank(const cv::Mat& src, const std::vector<cv::Mat>& kernels,
+                  std::vector<cv::Mat>& dsts, const int ddepth = CV_32F,
+                  const int delta = 0,
+                  const BorderMode border_mode = BorderMode::REPLICATE,
+                  uint8_t border_value = 0, const int num_threads = 0);
+
+/** Correlates an image streamed one row at a time with the provided kernel
+ *
+ *  Source rows are requested in increasing order, each exactly once, and
+ *  kept in a ring of kernel.rows rows, so memory is O(width * kernel.rows)
+ *  instead of O(width * height).  Filtered rows are delivered in increasing
+ *  order as soon as their neighborhood is available.
+ *
+ *  \param[in] size         size of the (CV_8UC3) source and destination
+ *  \param[in] source       callback filling a source row
+ *  \param[in] sink         callback receiving a filtered row
+ *  \param[in] kernel       correlation kernel, a single-channel matrix
+ *  \param[in] anchor       anchor of the kernel (default is the center)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ *  \param[in] method       filtering method (FFT is not available on a
+ *                          stream and is treated as AUTO)
+ *
+ *  \return                 false if a callback aborted the stream
+ */
+bool Filter2DStream(const cv::Size size, const RowSource& source,
+                    const RowSink& sink, const cv::Mat& kernel,
+                    const cv::Point anchor = cv::Point(-1, -1),
+                    const int delta = 0,
+                    const BorderMode border_mode = BorderMode::REPLICATE,
+                    uint8_t border_value = 0,
+                    const FilterMethod method = FilterMethod::AUTO);
 }
@@ -0,0 +1,168 @@
+/** Implementation file for filtering an image with a bank of kernels
+ *
+ *  \file ipcv/spatial_filtering/Filter2DBank.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "Filter2D.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "RowRing.h"
+#include "imgs/ipcv/utils/Parallel.h"
+
+using namespace std;
+
+namespace ipcv {
+
+// Output tile size [pixels]; smaller than the single kernel tiles since
+// every kernel writes its own destination rows
+static const int kTileRows = 32;
+static const int kTileCols = 256;
+
+/** Correlates an image with every kernel of a filter bank in a single pass
+ *
+ *  Each source neighborhood is loaded once and every kernel is evaluated
+ *  against it, so source memory traffic does not grow with the number of
+ *  kernels.  Kernels may differ in size; each is anchored at its center.
+ *
+ *  \param[in] src          source cv::Mat of CV_8UC1 or CV_8UC3
+ *  \param[in] kernels      correlation kernels, single-channel floating point
+ *                          matrices
+ *  \param[out] dsts        one destination cv::Mat per kernel, with the
+ *                          channels of src and the ddepth depth
+ *  \param[in] ddepth       desired depth of the destination images (CV_8U or
+ *                          CV_32F)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *                          before storing them in dsts
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ *  \param[in] num_threads  number of worker threads (if less than 1, use the
+ *                          number of hardware threads)
+ */
+bool Filter2DBank(const cv::Mat &src, const vector<cv::Mat> &kernels,
+                  vector<cv::Mat> &dsts, const int ddepth, const int delta,
+                  const BorderMode border_mode, uint8_t border_value,
+                  const int num_threads) {
+  if (src.depth() != CV_8U || (ddepth != CV_8U && ddepth != CV_32F)) {
+    cerr << "*** ERROR *** ";
+    cerr << "Filter2DBank supports CV_8U sources and CV_8U or CV_32F "
+            "destinations"
+         << endl;
+    return false;
+  }
+
+  int num_kernels = kernels.size();
+  vector<cv::Mat> kernels_f(num_kernels);
+  for (int k = 0; k < num_kernels; k++) {
+    if (kernels[k].channels() != 1) {
+      cerr << "*** ERROR *** ";
+      cerr << "Filter2DBank supports single-channel kernels" << endl;
+      return false;
+    }
+    kernels[k].convertTo(kernels_f[k], CV_32F);
+  }
+  int cn = src.channels();
+  dsts.resize(num_kernels);
+  for (int k = 0; k < num_kernels; k++) {
+    dsts[k].create(src.size(), CV_MAKETYPE(ddepth, cn));
+  }
+  if (num_kernels == 0) {
+    return true;
+  }
+
+  // Neighborhood covering every kernel once they are aligned on their
+  // centers
+  int top = 0;
+  int bottom = 0;
+  int left = 0;
+  int right = 0;
+  for (const auto &kernel : kernels_f) {
+    top = max(top, kernel.rows / 2);
+    bottom = max(bottom, kernel.rows - 1 - kernel.rows / 2);
+    left = max(left, kernel.cols / 2);
+    right = max(right, kernel.cols - 1 - kernel.cols / 2);
+  }
+
+  // Taps of the neighborhood used by at least one kernel, each holding the
+  // weights of all kernels contiguously
+  vector<int> tap_rows;
+  vector<int> tap_cols;
+  vector<float> tap_weights;
+  for (int i = 0; i < top + bottom + 1; i++) {
+    for (int j = 0; j < left + right + 1; j++) {
+      vector<float> weights(num_kernels, 0.0f);
+      bool used = false;
+      for (int k = 0; k < num_kernels; k++) {
+        int ki = i - top + kernels_f[k].rows / 2;
+        int kj = j - left + kernels_f[k].cols / 2;
+        if (ki >= 0 && ki < kernels_f[k].rows && kj >= 0 &&
+            kj < kernels_f[k].cols) {
+          weights[k] = kernels_f[k].at<float>(ki, kj);
+          used = used || weights[k] != 0;
+        }
+      }
+      if (used) {
+        tap_rows.push_back(i);
+        tap_cols.push_back(j);
+        tap_weights.insert(tap_weights.end(), weights.begin(), weights.end());
+      }
+    }
+  }
+  int num_taps = tap_rows.size();
+
+  int tiles_x = (src.cols + kTileCols - 1) / kTileCols;
+  int tiles_y = (src.rows + kTileRows - 1) / kTileRows;
+  ParallelFor(tiles_x * tiles_y, num_threads, [&](int begin, int end) {
+    vector<const uint8_t *> rows(top + bottom + 1);
+    vector<float> total(cn * num_kernels);
+    for (int idx = begin; idx < end; idx++) {
+      int x = (idx % tiles_x) * kTileCols;
+      int y = (idx / tiles_x) * kTileRows;
+      int width = min(kTileCols, src.cols - x);
+      int height = min(kTileRows, src.rows - y);
+
+      RowRing ring(src, x - left, width + left + right, top + bottom + 1,
+                   border_mode, border_value);
+      for (int r = y; r < y + height; r++) {
+        for (int i = 0; i < top + bottom + 1; i++) {
+          rows[i] = ring.Row(r - top + i);
+        }
+        for (int c = 0; c < width; c++) {
+          fill(total.begin(), total.end(), 0.0f);
+
+          // Every sample is read once and applied to all kernels
+          for (int t = 0; t < num_taps; t++) {
+            const uint8_t *s = rows[tap_rows[t]] + cn * (c + tap_cols[t]);
+            const float *w = &tap_weights[t * num_kernels];
+            for (int chan = 0; chan < cn; chan++) {
+              float value = s[chan];
+              float *acc = &total[chan * num_kernels];
+              for (int k = 0; k < num_kernels; k++) {
+                acc[k] += w[k] * value;
+              }
+            }
+          }
+
+          for (int k = 0; k < num_kernels; k++) {
+            for (int chan = 0; chan < cn; chan++) {
+              float value = total[chan * num_kernels + k] + delta;
+              if (ddepth == CV_8U) {
+                dsts[k].ptr<uint8_t>(r)[cn * (x + c) + chan] =
+                    cv::saturate_cast<uint8_t>(value);
+              } else {
+                dsts[k].ptr<float>(r)[cn * (x + c) + chan] = value;
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+
+  return true;
+}
+} // namespace ipcv
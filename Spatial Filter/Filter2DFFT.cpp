@@ -0,0 +1,93 @@
+/** Implementation file for frequency domain image filtering
+ *
+ *  \file ipcv/spatial_filtering/Filter2DFFT.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "Filter2D.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace ipcv {
+
+/** Correlates an image with the provided kernel by multiplying the spectra
+ *  of the border extended image and the zero padded kernel
+ *
+ *  \param[in] src          source cv::Mat of any depth and number of
+ *                          channels
+ *  \param[out] dst         destination cv::Mat with the channels of src
+ *  \param[in] ddepth       desired depth of the destination image (if
+ *                          negative, the depth of src)
+ *  \param[in] kernel       correlation kernel, a single-channel matrix of
+ *                          any depth
+ *  \param[in] anchor       anchor of the kernel (default is the center)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *                          before storing them in dst
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ */
+bool Filter2DFFT(const cv::Mat &src, cv::Mat &dst, const int ddepth,
+                 const cv::Mat &kernel, const cv::Point anchor,
+                 const int delta, const BorderMode border_mode,
+                 uint8_t border_value) {
+  int out_depth = ddepth < 0 ? src.depth() : CV_MAT_DEPTH(ddepth);
+  int ax = anchor.x < 0 ? kernel.cols / 2 : anchor.x;
+  int ay = anchor.y < 0 ? kernel.rows / 2 : anchor.y;
+
+  // Extend the source so every output pixel sees a full neighborhood
+  int border_type = cv::BORDER_REPLICATE;
+  if (border_mode == BorderMode::CONSTANT) {
+    border_type = cv::BORDER_CONSTANT;
+  } else if (border_mode == BorderMode::REFLECT_101) {
+    border_type = cv::BORDER_REFLECT_101;
+  }
+  cv::Mat padded;
+  cv::copyMakeBorder(src, padded, ay, kernel.rows - 1 - ay, ax,
+                     kernel.cols - 1 - ax, border_type,
+                     cv::Scalar::all(border_value));
+
+  // The transform only has to be as large as the extended source for the
+  // circular correlation to never wrap into the region we keep
+  int dft_rows = cv::getOptimalDFTSize(padded.rows);
+  int dft_cols = cv::getOptimalDFTSize(padded.cols);
+
+  // Kernel spectrum, shared by all channels
+  cv::Mat kernel_padded = cv::Mat::zeros(dft_rows, dft_cols, CV_32FC1);
+  cv::Mat kernel_roi =
+      kernel_padded(cv::Rect(0, 0, kernel.cols, kernel.rows));
+  kernel.convertTo(kernel_roi, CV_32F);
+  cv::Mat kernel_spectrum;
+  cv::dft(kernel_padded, kernel_spectrum, 0, kernel.rows);
+
+  vector<cv::Mat> channels;
+  cv::split(padded, channels);
+
+  cv::Mat plane = cv::Mat::zeros(dft_rows, dft_cols, CV_32FC1);
+  cv::Mat plane_roi = plane(cv::Rect(0, 0, padded.cols, padded.rows));
+  cv::Mat spectrum;
+  vector<cv::Mat> correlations(src.channels());
+  for (int chan = 0; chan < src.channels(); chan++) {
+    channels[chan].convertTo(plane_roi, CV_32F);
+    cv::dft(plane, spectrum, 0, padded.rows);
+
+    // Multiplying by the conjugate kernel spectrum correlates rather than
+    // convolves, matching the spatial path
+    cv::mulSpectrums(spectrum, kernel_spectrum, spectrum, 0, true);
+    cv::Mat correlation;
+    cv::dft(spectrum, correlation,
+            cv::DFT_INVERSE | cv::DFT_SCALE | cv::DFT_REAL_OUTPUT, src.rows);
+    correlations[chan] = correlation(cv::Rect(0, 0, src.cols, src.rows));
+  }
+
+  // Interleave the channels and saturate to the destination depth
+  cv::Mat merged;
+  cv::merge(correlations, merged);
+  merged.convertTo(dst, out_depth, 1, delta);
+
+  return true;
+}
+} // namespace ipcv
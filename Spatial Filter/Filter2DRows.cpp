@@ -0,0 +1,294 @@
+/** Implementation file for the row kernels shared by the image filtering
+ *  paths
+ *
+ *  \file ipcv/spatial_filtering/Filter2DRows.cpp
+ *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
+ *  \edited Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "Filter2DRows.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+using namespace std;
+
+namespace ipcv {
+
+// Ratio of the second to the first singular value of the kernel below which
+// the kernel is considered to be of rank 1 (separable)
+static const double kSeparableTolerance = 1e-6;
+
+// Largest worst-case error [digital counts] the quantized kernel may
+// introduce for AUTO to prefer the fixed point path over floating point
+static const double kFixedPointMaxError = 0.5;
+
+/** Splits a kernel into a column and a row vector if it is of rank 1
+ *
+ *  \param[in] kernel     single-channel floating point kernel
+ *  \param[out] kernel_y  kernel.rows x 1 vertical (column) filter
+ *  \param[out] kernel_x  1 x kernel.cols horizontal (row) filter
+ *
+ *  \return               true if kernel = kernel_y * kernel_x
+ */
+static bool SeparateKernel(const cv::Mat &kernel, cv::Mat &kernel_y,
+                           cv::Mat &kernel_x) {
+  cv::Mat w;
+  cv::Mat u;
+  cv::Mat vt;
+  cv::SVD::compute(kernel, w, u, vt);
+
+  // A kernel with no energy is not worth a second pass
+  float s0 = w.at<float>(0);
+  if (s0 <= 0) {
+    return false;
+  }
+  if (w.rows > 1 && w.at<float>(1) > kSeparableTolerance * s0) {
+    return false;
+  }
+
+  // Distribute the singular value evenly between the two vectors
+  float scale = sqrt(s0);
+  kernel_y = u.col(0) * scale;
+  kernel_x = vt.row(0) * scale;
+
+  return true;
+}
+
+/** Quantizes a floating point kernel to 16-bit fixed point
+ *
+ *  The shift is the largest one for which every weight fits in an int16 and
+ *  the sum of |weight| * 255 over the kernel cannot overflow an int32
+ *  accumulator.
+ *
+ *  \param[in] kernel  single-channel floating point kernel
+ *  \param[out] fixed  quantized kernel
+ *
+ *  \return            false if the kernel weights are too large to quantize
+ */
+static bool QuantizeKernel(const cv::Mat &kernel, FixedPointKernel &fixed) {
+  double max_weight = 0;
+  for (int i = 0; i < kernel.rows; i++) {
+    const float *k_ptr = kernel.ptr<float>(i);
+    for (int j = 0; j < kernel.cols; j++) {
+      max_weight = max(max_weight, static_cast<double>(fabs(k_ptr[j])));
+    }
+  }
+  if (max_weight == 0) {
+    return false;
+  }
+
+  fixed.rows = kernel.rows;
+  fixed.cols = kernel.cols;
+  fixed.weights.resize(kernel.rows * kernel.cols);
+  int pairs_per_row = (kernel.cols + 1) / 2;
+
+  // Start from the finest scale that keeps every weight within an int16 and
+  // back off until the worst-case accumulator fits in an int32
+  int shift = min(24, static_cast<int>(floor(log2(32767 / max_weight))));
+  for (; shift >= 0; shift--) {
+    double worst_case = shift > 0 ? ldexp(1, shift - 1) : 0;
+    fixed.max_error = 0;
+    for (int i = 0; i < kernel.rows; i++) {
+      const float *k_ptr = kernel.ptr<float>(i);
+      for (int j = 0; j < kernel.cols; j++) {
+        int w = static_cast<int>(lround(ldexp(k_ptr[j], shift)));
+        fixed.weights[i * kernel.cols + j] = w;
+        fixed.max_error += 255 * fabs(ldexp(w, -shift) - k_ptr[j]);
+        worst_case += 255.0 * abs(w);
+      }
+    }
+    if (worst_case <= 2147483647.0) {
+      break;
+    }
+  }
+  if (shift < 0) {
+    return false;
+  }
+  fixed.shift = shift;
+
+  fixed.pairs.assign(kernel.rows * pairs_per_row, 0);
+  for (int i = 0; i < kernel.rows; i++) {
+    for (int j = 0; j < kernel.cols; j++) {
+      // Low half holds the even tap, high half the odd tap
+      uint32_t half = static_cast<uint16_t>(
+          static_cast<int16_t>(fixed.weights[i * kernel.cols + j]));
+      fixed.pairs[i * pairs_per_row + j / 2] |=
+          static_cast<int32_t>(j % 2 == 0 ? half : half << 16);
+    }
+  }
+
+  return true;
+}
+
+/** Prepares a kernel for the spatial path suited to it
+ *
+ *  Rank-1 kernels (box, Gaussian, ...) are applied as two 1D passes.
+ *  Non-separable kernels use 16-bit fixed point weights when the
+ *  quantization error is negligible (or when asked to) and floating point
+ *  otherwise.
+ *
+ *  \param[in] kernel             single-channel floating point kernel
+ *  \param[in] method             requested filtering method
+ *  \param[in] allow_fixed_point  whether source and destination are both
+ *                                8-bit, as the fixed point path requires
+ *
+ *  \return                       kernel prepared for its path
+ */
+SpatialKernel PrepareKernel(const cv::Mat &kernel, const FilterMethod method,
+                            const bool allow_fixed_point) {
+  SpatialKernel prepared;
+  prepared.kernel = kernel;
+
+  cv::Mat kernel_y;
+  cv::Mat kernel_x;
+  if (!(allow_fixed_point && method == FilterMethod::FIXED_POINT) &&
+      kernel.rows > 1 &&
+      kernel.cols > 1 && SeparateKernel(kernel, kernel_y, kernel_x)) {
+    prepared.path = SpatialPath::SEPARABLE;
+    for (int i = 0; i < kernel.rows; i++) {
+      prepared.ky.push_back(kernel_y.at<float>(i));
+    }
+    for (int j = 0; j < kernel.cols; j++) {
+      prepared.kx.push_back(kernel_x.at<float>(j));
+    }
+    return prepared;
+  }
+
+  prepared.path = SpatialPath::DIRECT;
+  if (allow_fixed_point &&
+      (method == FilterMethod::AUTO || method == FilterMethod::FIXED_POINT) &&
+      QuantizeKernel(kernel, prepared.fixed) &&
+      (method == FilterMethod::FIXED_POINT ||
+       prepared.fixed.max_error < kFixedPointMaxError)) {
+    prepared.path = SpatialPath::FIXED_POINT;
+  }
+  return prepared;
+}
+
+/** Correlates one row of interleaved 8-bit samples with a fixed point kernel
+ *
+ *  Channels do not need to be separated: a kernel column step is a stride
+ *  of cn samples, so the row is filtered as one run of n samples.
+ *
+ *  \param[in] rows   kernel.rows source row pointers, each positioned at the
+ *                    sample under the kernel's top left tap for the first
+ *                    output sample
+ *  \param[in] fixed  quantized kernel
+ *  \param[in] cn     number of interleaved channels
+ *  \param[in] delta  value added to the filtered samples
+ *  \param[out] dst   n output samples
+ *  \param[in] n      number of output samples
+ */
+void FixedPointRow(const uint8_t *const *rows, const FixedPointKernel &fixed,
+                   const int cn, const int delta, uint8_t *dst, const int n) {
+  int32_t rounding = fixed.shift > 0 ? 1 << (fixed.shift - 1) : 0;
+  int x = 0;
+
+#if defined(__AVX2__)
+  // 16 output samples per iteration, two taps per multiply-add
+  const int pairs_per_row = (fixed.cols + 1) / 2;
+  const __m256i round_vec = _mm256_set1_epi32(rounding);
+  const __m128i shift_vec = _mm_cvtsi32_si128(fixed.shift);
+  const __m256i delta_vec = _mm256_set1_epi32(delta);
+  const __m128i zero = _mm_setzero_si128();
+  for (; x + 16 <= n; x += 16) {
+    __m256i acc_lo = _mm256_setzero_si256();
+    __m256i acc_hi = _mm256_setzero_si256();
+    for (int i = 0; i < fixed.rows; i++) {
+      const uint8_t *s = rows[i] + x;
+      const int32_t *pairs = &fixed.pairs[i * pairs_per_row];
+      for (int p = 0; p < pairs_per_row; p++) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+        __m128i b = zero;
+        if (2 * p + 1 < fixed.cols) {
+          b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + cn));
+        }
+        __m256i w = _mm256_set1_epi32(pairs[p]);
+        __m256i lo = _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(a, b));
+        __m256i hi = _mm256_cvtepu8_epi16(_mm_unpackhi_epi8(a, b));
+        acc_lo = _mm256_add_epi32(acc_lo, _mm256_madd_epi16(lo, w));
+        acc_hi = _mm256_add_epi32(acc_hi, _mm256_madd_epi16(hi, w));
+        s += 2 * cn;
+      }
+    }
+    acc_lo = _mm256_add_epi32(
+        _mm256_sra_epi32(_mm256_add_epi32(acc_lo, round_vec), shift_vec),
+        delta_vec);
+    acc_hi = _mm256_add_epi32(
+        _mm256_sra_epi32(_mm256_add_epi32(acc_hi, round_vec), shift_vec),
+        delta_vec);
+
+    // packs works within 128-bit lanes, so restore the sample order before
+    // the final narrowing
+    __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(acc_lo, acc_hi), 0xD8);
+    __m128i out = _mm_packus_epi16(_mm256_castsi256_si128(packed),
+                                   _mm256_extracti128_si256(packed, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), out);
+  }
+#elif defined(__SSE4_1__)
+  // 16 output samples per iteration, two taps per multiply-add
+  const int pairs_per_row = (fixed.cols + 1) / 2;
+  const __m128i round_vec = _mm_set1_epi32(rounding);
+  const __m128i shift_vec = _mm_cvtsi32_si128(fixed.shift);
+  const __m128i delta_vec = _mm_set1_epi32(delta);
+  const __m128i zero = _mm_setzero_si128();
+  for (; x + 16 <= n; x += 16) {
+    __m128i acc[4] = {zero, zero, zero, zero};
+    for (int i = 0; i < fixed.rows; i++) {
+      const uint8_t *s = rows[i] + x;
+      const int32_t *pairs = &fixed.pairs[i * pairs_per_row];
+      for (int p = 0; p < pairs_per_row; p++) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+        __m128i b = zero;
+        if (2 * p + 1 < fixed.cols) {
+          b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + cn));
+        }
+        __m128i w = _mm_set1_epi32(pairs[p]);
+        __m128i lo = _mm_unpacklo_epi8(a, b);
+        __m128i hi = _mm_unpackhi_epi8(a, b);
+        acc[0] = _mm_add_epi32(acc[0],
+                               _mm_madd_epi16(_mm_cvtepu8_epi16(lo), w));
+        acc[1] = _mm_add_epi32(
+            acc[1], _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), w));
+        acc[2] = _mm_add_epi32(acc[2],
+                               _mm_madd_epi16(_mm_cvtepu8_epi16(hi), w));
+        acc[3] = _mm_add_epi32(
+            acc[3], _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), w));
+        s += 2 * cn;
+      }
+    }
+    for (int k = 0; k < 4; k++) {
+      acc[k] = _mm_add_epi32(
+          _mm_sra_epi32(_mm_add_epi32(acc[k], round_vec), shift_vec),
+          delta_vec);
+    }
+    __m128i out = _mm_packus_epi16(_mm_packs_epi32(acc[0], acc[1]),
+                                   _mm_packs_epi32(acc[2], acc[3]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), out);
+  }
+#endif
+
+  // Scalar fallback (and remainder), same integer arithmetic as above
+  for (; x < n; x++) {
+    int32_t total = 0;
+    for (int i = 0; i < fixed.rows; i++) {
+      const uint8_t *s = rows[i] + x;
+      const int32_t *weights = &fixed.weights[i * fixed.cols];
+      for (int j = 0; j < fixed.cols; j++) {
+        total += weights[j] * s[cn * j];
+      }
+    }
+    dst[x] = cv::saturate_cast<uint8_t>(((total + rounding) >> fixed.shift) +
+                                        delta);
+  }
+}
+} // namespace ipcv
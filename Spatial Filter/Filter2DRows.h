@@ -0,0 +1,190 @@
+/** Interface file for the row kernels shared by the image filtering paths
+ *
+ *  These are building blocks of Filter2D and its streaming variant, not part
+ *  of the public filtering interface.
+ *
+ *  \file ipcv/spatial_filtering/Filter2DRows.h
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "Filter2D.h"
+
+namespace ipcv {
+
+// Ways a spatial correlation is carried out
+enum class SpatialPath {
+  DIRECT,     // Full 2D kernel in floating point
+  SEPARABLE,  // Horizontal then vertical 1D pass in floating point
+  FIXED_POINT // Full 2D kernel in 16-bit fixed point
+};
+
+/** Kernel quantized to 16-bit fixed point for 8-bit sources
+ *
+ *  Weights are scaled by 2^shift and rounded.  Horizontally adjacent taps
+ *  are also packed as int16 pairs into one int32 so that a single multiply-
+ *  add instruction applies two taps (an odd last tap is paired with zero).
+ */
+struct FixedPointKernel {
+  int rows;
+  int cols;
+  int shift;
+  double max_error;
+  std::vector<int32_t> weights;
+  std::vector<int32_t> pairs;
+};
+
+// Kernel prepared for one of the spatial paths
+struct SpatialKernel {
+  SpatialPath path;
+  cv::Mat kernel;
+  std::vector<float> ky;
+  std::vector<float> kx;
+  FixedPointKernel fixed;
+};
+
+/** Prepares a kernel for the spatial path suited to it
+ *
+ *  \param[in] kernel             single-channel floating point kernel
+ *  \param[in] method             requested filtering method
+ *  \param[in] allow_fixed_point  whether source and destination are both
+ *                                8-bit, as the fixed point path requires
+ *
+ *  \return                       kernel prepared for its path
+ */
+SpatialKernel PrepareKernel(const cv::Mat& kernel, const FilterMethod method,
+                            const bool allow_fixed_point);
+
+/** Correlates one row of interleaved 8-bit samples with a fixed point kernel
+ *
+ *  \param[in] rows   fixed.rows extended source rows
+ *  \param[in] fixed  quantized kernel
+ *  \param[in] cn     number of interleaved channels
+ *  \param[in] delta  value added to the filtered samples
+ *  \param[out] dst   n output samples
+ *  \param[in] n      number of output samples
+ */
+void FixedPointRow(const uint8_t* const* rows, const FixedPointKernel& fixed,
+                   const int cn, const int delta, uint8_t* dst, const int n);
+
+/** Correlates one row of interleaved samples of type T with the full 2D
+ *  kernel (O(kernel.rows * kernel.cols) per sample)
+ *
+ *  Channels do not need to be separated: a kernel column step is a stride
+ *  of cn samples, so the row is filtered as one run of n samples.
+ *
+ *  \param[in] rows    kernel.rows extended source rows, each positioned at
+ *                     the pixel under the kernel's left column for the first
+ *                     output pixel
+ *  \param[in] kernel  single-channel CV_32F kernel
+ *  \param[in] cn      number of interleaved channels
+ *  \param[in] delta   value added to the filtered samples
+ *  \param[out] dst    n output samples
+ *  \param[in] n       number of output samples
+ */
+template <typename T, typename D>
+void DirectRow(const uint8_t* const* rows, const cv::Mat& kernel,
+               const int cn, const int delta, D* dst, const int n) {
+  for (int x = 0; x < n; x++) {
+    float total = 0;
+    for (int i = 0; i < kernel.rows; i++) {
+      const float* k_ptr = kernel.ptr<float>(i);
+      const T* s = reinterpret_cast<const T*>(rows[i]) + x;
+      for (int j = 0; j < kernel.cols; j++) {
+        total += k_ptr[j] * s[cn * j];
+      }
+    }
+    dst[x] = cv::saturate_cast<D>(total + delta);
+  }
+}
+
+/** Correlates one row of interleaved samples of type T with a KH x KW
+ *  kernel whose size is known at compile time
+ *
+ *  Both tap loops have constant trip counts, so the compiler unrolls them
+ *  completely and keeps every weight in a register across the row.  The
+ *  taps are summed in the same order as DirectRow, so the results are
+ *  identical.
+ *
+ *  \param[in] rows     KH extended source rows
+ *  \param[in] weights  kernel weights
+ *  \param[in] cn       number of interleaved channels
+ *  \param[in] delta    value added to the filtered samples
+ *  \param[out] dst     n output samples
+ *  \param[in] n        number of output samples
+ */
+template <int KH, int KW, typename T, typename D>
+void SmallKernelRow(const uint8_t* const* rows, const float (&weights)[KH][KW],
+                    const int cn, const int delta, D* dst, const int n) {
+  const T* src[KH];
+  for (int i = 0; i < KH; i++) {
+    src[i] = reinterpret_cast<const T*>(rows[i]);
+  }
+  for (int x = 0; x < n; x++) {
+    float total = 0;
+    for (int i = 0; i < KH; i++) {
+      for (int j = 0; j < KW; j++) {
+        total += weights[i][j] * src[i][x + cn * j];
+      }
+    }
+    dst[x] = cv::saturate_cast<D>(total + delta);
+  }
+}
+
+/** Correlates one row of interleaved samples of type T with the horizontal
+ *  vector of a separable kernel
+ *
+ *  \param[in] src  extended source row, positioned at the pixel under the
+ *                  kernel's left column for the first output pixel
+ *  \param[in] kx   horizontal (row) filter
+ *  \param[in] cn   number of interleaved channels
+ *  \param[out] dst n filtered samples
+ *  \param[in] n    number of output samples
+ */
+template <typename T>
+void HorizontalRow(const uint8_t* src, const std::vector<float>& kx,
+                   const int cn, float* dst, const int n) {
+  int kw = kx.size();
+  for (int x = 0; x < n; x++) {
+    const T* s = reinterpret_cast<const T*>(src) + x;
+    float total = 0;
+    for (int j = 0; j < kw; j++) {
+      total += kx[j] * s[cn * j];
+    }
+    dst[x] = total;
+  }
+}
+
+/** Correlates horizontally filtered rows with the vertical vector of a
+ *  separable kernel, a full row at a time so the inner loop walks
+ *  contiguous memory
+ *
+ *  \param[in] rows   ky.size() horizontally filtered rows
+ *  \param[in] ky     vertical (column) filter
+ *  \param[in] delta  value added to the filtered samples
+ *  \param[out] dst   n output samples
+ *  \param[in] n      number of output samples
+ *  \param[in] total  scratch space for n samples
+ */
+template <typename D>
+void VerticalRow(const float* const* rows, const std::vector<float>& ky,
+                 const int delta, D* dst, const int n, float* total) {
+  std::fill(total, total + n, 0.0f);
+  for (size_t i = 0; i < ky.size(); i++) {
+    const float* row = rows[i];
+    for (int x = 0; x < n; x++) {
+      total[x] += ky[i] * row[x];
+    }
+  }
+  for (int x = 0; x < n; x++) {
+    dst[x] = cv::saturate_cast<D>(total[x] + delta);
+  }
+}
+}
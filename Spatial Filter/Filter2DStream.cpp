@@ -0,0 +1,127 @@
+/** Implementation file for filtering images streamed one row at a time
+ *
+ *  \file ipcv/spatial_filtering/Filter2DStream.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "Filter2D.h"
+
+#include <vector>
+
+#include "Filter2DRows.h"
+#include "RowRing.h"
+
+using namespace std;
+
+namespace ipcv {
+
+/** Correlates an image streamed one row at a time with the provided kernel
+ *
+ *  Source rows are requested in increasing order, each exactly once, and
+ *  kept in a ring of kernel.rows rows, so memory is O(width * kernel.rows)
+ *  instead of O(width * height).  Filtered rows are delivered in increasing
+ *  order as soon as their neighborhood is available.
+ *
+ *  \param[in] size         size of the (CV_8UC3) source and destination
+ *  \param[in] source       callback filling a source row
+ *  \param[in] sink         callback receiving a filtered row
+ *  \param[in] kernel       correlation kernel, a single-channel matrix
+ *  \param[in] anchor       anchor of the kernel (default is the center)
+ *  \param[in] delta        optional value added to the filtered pixels
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value to use for constant border mode
+ *  \param[in] method       filtering method (FFT is not available on a
+ *                          stream and is treated as AUTO)
+ *
+ *  \return                 false if a callback aborted the stream
+ */
+bool Filter2DStream(const cv::Size size, const RowSource &source,
+                    const RowSink &sink, const cv::Mat &kernel,
+                    const cv::Point anchor, const int delta,
+                    const BorderMode border_mode, uint8_t border_value,
+                    const FilterMethod method) {
+  int kh = kernel.rows;
+  int kw = kernel.cols;
+  int ax = anchor.x < 0 ? kw / 2 : anchor.x;
+  int ay = anchor.y < 0 ? kh / 2 : anchor.y;
+
+  cv::Mat kernel_f;
+  kernel.convertTo(kernel_f, CV_32F);
+  SpatialKernel prepared = PrepareKernel(
+      kernel_f, method == FilterMethod::FFT ? FilterMethod::AUTO : method,
+      true);
+  bool separable = prepared.path == SpatialPath::SEPARABLE;
+
+  // Source rows are extended by the kernel apron as they arrive; separable
+  // kernels keep the horizontally filtered rows instead
+  int cols = size.width;
+  size_t ext_bytes = 3 * (cols + kw - 1);
+  size_t slot_bytes = separable ? 3 * cols * sizeof(float) : ext_bytes;
+  vector<uint8_t> raw(3 * cols);
+  vector<uint8_t> extended(ext_bytes);
+  vector<uint8_t> ring(kh * slot_bytes);
+  uint8_t border_pixel[3] = {border_value, border_value, border_value};
+
+  // Row standing in for every row outside a constant border
+  vector<uint8_t> constant_row(ext_bytes, border_value);
+  vector<uint8_t> constant_slot(constant_row);
+  if (separable) {
+    constant_slot.resize(slot_bytes);
+    HorizontalRow<uint8_t>(constant_row.data(), prepared.kx, 3,
+                           reinterpret_cast<float *>(constant_slot.data()),
+                           3 * cols);
+  }
+
+  // Reads source rows up to and including row; the rows a neighborhood
+  // needs never span more than kernel.rows rows, even where the border
+  // reflects, so a slot is only reused once its row is no longer needed
+  int next_row = 0;
+  bool streaming = true;
+  auto fetch = [&](const int row) -> const uint8_t * {
+    for (; streaming && next_row <= row; next_row++) {
+      uint8_t *slot = &ring[(next_row % kh) * slot_bytes];
+      streaming = source(next_row, raw.data());
+      uint8_t *out = separable ? extended.data() : slot;
+      ExtendRow(raw.data(), cols, 3, -ax, cols + kw - 1, border_mode,
+                border_pixel, out);
+      if (separable) {
+        HorizontalRow<uint8_t>(out, prepared.kx, 3,
+                               reinterpret_cast<float *>(slot), 3 * cols);
+      }
+    }
+    return &ring[(row % kh) * slot_bytes];
+  };
+
+  vector<const uint8_t *> rows(kh);
+  vector<const float *> rows_filtered(kh);
+  vector<uint8_t> dst_row(3 * cols);
+  vector<float> total(3 * cols);
+  for (int r = 0; r < size.height && streaming; r++) {
+    for (int i = 0; i < kh; i++) {
+      int row = BorderIndex(r - ay + i, size.height, border_mode);
+      rows[i] = row < 0 ? constant_slot.data() : fetch(row);
+    }
+    if (!streaming) {
+      break;
+    }
+
+    if (separable) {
+      for (int i = 0; i < kh; i++) {
+        rows_filtered[i] = reinterpret_cast<const float *>(rows[i]);
+      }
+      VerticalRow(rows_filtered.data(), prepared.ky, delta, dst_row.data(),
+                  3 * cols, total.data());
+    } else if (prepared.path == SpatialPath::FIXED_POINT) {
+      FixedPointRow(rows.data(), prepared.fixed, 3, delta, dst_row.data(),
+                    3 * cols);
+    } else {
+      DirectRow<uint8_t, uint8_t>(rows.data(), prepared.kernel, 3, delta,
+                                  dst_row.data(), 3 * cols);
+    }
+    streaming = sink(r, dst_row.data());
+  }
+
+  return streaming;
+}
+} // namespace ipcv
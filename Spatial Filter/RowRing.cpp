@@ -0,0 +1,120 @@
+/** Implementation file for border extended source rows used by image
+ *  filtering
+ *
+ *  \file ipcv/spatial_filtering/RowRing.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "RowRing.h"
+
+#include <climits>
+#include <cstring>
+
+using namespace std;
+
+namespace ipcv {
+
+/** Copy a span of a source row, extrapolating the samples outside of it
+ *
+ *  \param[in] src_row      source row
+ *  \param[in] src_cols     number of pixels in the source row
+ *  \param[in] elem_size    size of a pixel [bytes]
+ *  \param[in] first_col    source column of the first output pixel (may be
+ *                          negative)
+ *  \param[in] width        number of output pixels
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_pixel elem_size bytes used for constant border mode
+ *  \param[out] out         width * elem_size bytes
+ */
+void ExtendRow(const uint8_t *src_row, const int src_cols,
+               const size_t elem_size, const int first_col, const int width,
+               const BorderMode border_mode, const uint8_t *border_pixel,
+               uint8_t *out) {
+  // Pixels inside the source are copied as one block
+  int inside_begin = min(max(first_col, 0), src_cols);
+  int inside_end = max(min(first_col + width, src_cols), inside_begin);
+  if (inside_end > inside_begin) {
+    memcpy(out + (inside_begin - first_col) * elem_size,
+           src_row + inside_begin * elem_size,
+           (inside_end - inside_begin) * elem_size);
+  }
+
+  // Only the apron pixels outside the source are extrapolated one at a time
+  int left_end = min(width, inside_begin - first_col);
+  int right_begin = max(left_end, inside_end - first_col);
+  auto extrapolate = [&](const int p) {
+    int sc = BorderIndex(first_col + p, src_cols, border_mode);
+    const uint8_t *pixel =
+        sc < 0 ? border_pixel : src_row + static_cast<size_t>(sc) * elem_size;
+    memcpy(out + p * elem_size, pixel, elem_size);
+  };
+  for (int p = 0; p < left_end; p++) {
+    extrapolate(p);
+  }
+  for (int p = right_begin; p < width; p++) {
+    extrapolate(p);
+  }
+}
+
+/** Constructor
+ *
+ *  \param[in] src          source cv::Mat
+ *  \param[in] first_col    source column of the first pixel of each row
+ *                          (may be negative)
+ *  \param[in] width        number of pixels in each row
+ *  \param[in] num_rows     number of rows in the ring (kernel height)
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_value value of every sample for constant border mode
+ */
+RowRing::RowRing(const cv::Mat &src, const int first_col, const int width,
+                 const int num_rows, const BorderMode border_mode,
+                 const uint8_t border_value)
+    : src_(src), first_col_(first_col), width_(width), num_rows_(num_rows),
+      border_mode_(border_mode) {
+  in_bounds_ = first_col >= 0 && first_col + width <= src.cols;
+  row_bytes_ = width * src.elemSize();
+  slots_.resize(num_rows * row_bytes_);
+  slot_rows_.assign(num_rows, INT_MIN);
+
+  // The border value is converted to the source type once, so samples wider
+  // than a byte hold the value rather than a repeated byte pattern
+  cv::Mat pixel(1, 1, src.type(), cv::Scalar::all(border_value));
+  border_pixel_.assign(pixel.ptr<uint8_t>(0),
+                       pixel.ptr<uint8_t>(0) + src.elemSize());
+  if (border_mode == BorderMode::CONSTANT) {
+    constant_row_.resize(row_bytes_);
+    for (int p = 0; p < width; p++) {
+      memcpy(&constant_row_[p * src.elemSize()], border_pixel_.data(),
+             src.elemSize());
+    }
+  }
+}
+
+/** Extended source row
+ *
+ *  \param[in] row  source row index (may be out of range)
+ *
+ *  \return         pointer to width pixels starting at first_col
+ */
+const uint8_t *RowRing::Row(const int row) {
+  int src_row = BorderIndex(row, src_.rows, border_mode_);
+  if (src_row < 0) {
+    return constant_row_.data();
+  }
+  if (in_bounds_) {
+    return src_.ptr<uint8_t>(src_row) + first_col_ * src_.elemSize();
+  }
+
+  // Slots are indexed by the requested row, so a sliding window of num_rows
+  // rows never evicts a row it still needs
+  int slot = ((row % num_rows_) + num_rows_) % num_rows_;
+  uint8_t *out = &slots_[slot * row_bytes_];
+  if (slot_rows_[slot] != row) {
+    ExtendRow(src_.ptr<uint8_t>(src_row), src_.cols, src_.elemSize(),
+              first_col_, width_, border_mode_, border_pixel_.data(), out);
+    slot_rows_[slot] = row;
+  }
+  return out;
+}
+} // namespace ipcv
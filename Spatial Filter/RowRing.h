@@ -0,0 +1,82 @@
+/** Interface file for border extended source rows used by image filtering
+ *
+ *  \file ipcv/spatial_filtering/RowRing.h
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "imgs/ipcv/utils/BorderMode.h"
+
+namespace ipcv {
+
+/** Copy a span of a source row, extrapolating the samples outside of it
+ *
+ *  \param[in] src_row      source row
+ *  \param[in] src_cols     number of pixels in the source row
+ *  \param[in] elem_size    size of a pixel [bytes]
+ *  \param[in] first_col    source column of the first output pixel (may be
+ *                          negative)
+ *  \param[in] width        number of output pixels
+ *  \param[in] border_mode  pixel extrapolation method
+ *  \param[in] border_pixel elem_size bytes used for constant border mode
+ *  \param[out] out         width * elem_size bytes
+ */
+void ExtendRow(const uint8_t* src_row, const int src_cols,
+               const size_t elem_size, const int first_col, const int width,
+               const BorderMode border_mode, const uint8_t* border_pixel,
+               uint8_t* out);
+
+/** Ring buffer of source rows extended horizontally (and vertically) by the
+ *  kernel apron and the border mode
+ *
+ *  Rows are requested by their (possibly out of range) source row index.
+ *  Rows whose span lies inside the source are returned in place; the others
+ *  are extended into one of num_rows slots, so filtering loops can read
+ *  every row of the kernel neighborhood without testing bounds.  Requesting
+ *  rows in increasing order with a window of num_rows extends each row only
+ *  once.
+ */
+class RowRing {
+ public:
+  /** Constructor
+   *
+   *  \param[in] src          source cv::Mat
+   *  \param[in] first_col    source column of the first pixel of each row
+   *                          (may be negative)
+   *  \param[in] width        number of pixels in each row
+   *  \param[in] num_rows     number of rows in the ring (kernel height)
+   *  \param[in] border_mode  pixel extrapolation method
+   *  \param[in] border_value value of every sample for constant border mode
+   */
+  RowRing(const cv::Mat& src, const int first_col, const int width,
+          const int num_rows, const BorderMode border_mode,
+          const uint8_t border_value);
+
+  /** Extended source row
+   *
+   *  \param[in] row  source row index (may be out of range)
+   *
+   *  \return         pointer to width pixels starting at first_col
+   */
+  const uint8_t* Row(const int row);
+
+ private:
+  const cv::Mat& src_;
+  int first_col_;
+  int width_;
+  int num_rows_;
+  BorderMode border_mode_;
+  bool in_bounds_;
+  size_t row_bytes_;
+  std::vector<uint8_t> border_pixel_;
+  std::vector<uint8_t> constant_row_;
+  std::vector<uint8_t> slots_;
+  std::vector<int> slot_rows_;
+};
+}
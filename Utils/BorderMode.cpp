@@ -0,0 +1,48 @@
+/** Implementation file for the pixel extrapolation methods shared by the
+ *  image processing modules
+ *
+ *  \file ipcv/utils/BorderMode.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "BorderMode.h"
+
+namespace ipcv {
+
+/** Map a possibly out of range index onto [0, len) for a border mode
+ *
+ *  \param[in] p            index to map
+ *  \param[in] len          length of the dimension
+ *  \param[in] border_mode  pixel extrapolation method
+ *
+ *  \return                 mapped index, or -1 for the constant border value
+ *                          and for an empty dimension
+ */
+int BorderIndex(int p, const int len, const BorderMode border_mode) {
+  if (p >= 0 && p < len) {
+    return p;
+  }
+
+  // An empty dimension has no pixel to extrapolate from
+  if (len <= 0) {
+    return -1;
+  }
+  switch (border_mode) {
+  case BorderMode::CONSTANT:
+    return -1;
+  case BorderMode::REPLICATE:
+    return p < 0 ? 0 : len - 1;
+  case BorderMode::REFLECT_101:
+    if (len == 1) {
+      return 0;
+    }
+    // Indices more than an image length outside reflect more than once
+    while (p < 0 || p >= len) {
+      p = p < 0 ? -p : 2 * (len - 1) - p;
+    }
+    return p;
+  }
+  return -1;
+}
+} // namespace ipcv
@@ -0,0 +1,30 @@
+/** Interface file for the pixel extrapolation methods shared by the image
+ *  processing modules
+ *
+ *  \file ipcv/utils/BorderMode.h
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+namespace ipcv {
+
+// Available border modes
+enum class BorderMode {
+  CONSTANT,    // Use background color
+  REPLICATE,   // Replicate border pixels
+  REFLECT_101  // Reflect about the border pixels (gfedcb|abcdefgh|gfedcba)
+};
+
+/** Map a possibly out of range index onto [0, len) for a border mode
+ *
+ *  \param[in] p            index to map
+ *  \param[in] len          length of the dimension
+ *  \param[in] border_mode  pixel extrapolation method
+ *
+ *  \return                 mapped index, or -1 for the constant border value
+ *                          and for an empty dimension
+ */
+int BorderIndex(int p, const int len, const BorderMode border_mode);
+}
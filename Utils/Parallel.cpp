@@ -0,0 +1,199 @@
+/** Implementation file for distributing work over a pool of threads
+ *
+ *  \file ipcv/utils/Parallel.cpp
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace ipcv {
+
+/** One ParallelFor call, shared by the caller and the helpers that join it
+ *
+ *  The caller works on the range too and only waits for helpers that have
+ *  started, so a call completes even if no helper is free (e.g. when it is
+ *  made from inside another ParallelFor body).
+ */
+struct ParallelJob {
+  const function<void(int, int)> *body;
+  int count;
+  int chunk;
+  int num_chunks;
+  atomic<int> next_chunk{0};
+  mutex join_mutex;
+  condition_variable finished;
+  int active = 0;     // helpers working on the range
+  exception_ptr error; // first exception thrown by body
+
+  /** Claims chunks until the range is exhausted, or body throws, which
+   *  stops every participant from claiming more
+   */
+  void Run() {
+    try {
+      for (int idx = next_chunk++; idx < num_chunks; idx = next_chunk++) {
+        int begin = idx * chunk;
+        (*body)(begin, min(begin + chunk, count));
+      }
+    } catch (...) {
+      next_chunk = num_chunks;
+      lock_guard<mutex> lock(join_mutex);
+      if (!error) {
+        error = current_exception();
+      }
+    }
+  }
+
+  /** Joins as a helper, unless the range is already exhausted */
+  void Help() {
+    {
+      lock_guard<mutex> lock(join_mutex);
+      if (next_chunk >= num_chunks) {
+        return;
+      }
+      active++;
+    }
+    Run();
+    lock_guard<mutex> lock(join_mutex);
+    if (--active == 0) {
+      finished.notify_all();
+    }
+  }
+
+  /** Waits for the helpers that joined */
+  void Wait() {
+    unique_lock<mutex> lock(join_mutex);
+    finished.wait(lock, [this] { return active == 0; });
+  }
+};
+
+/** Worker threads kept for the life of the program, grown on demand to the
+ *  largest number of helpers requested, but never beyond the hardware
+ *  threads (chunks are claimed dynamically, so more would only sit idle)
+ */
+class ThreadPool {
+ public:
+  static ThreadPool &Instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  ~ThreadPool() {
+    {
+      lock_guard<mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &t : threads_) {
+      t.join();
+    }
+  }
+
+  /** Offers a job to a number of helper threads */
+  void Submit(const shared_ptr<ParallelJob> &job, const int helpers) {
+    int limit = min(helpers, ThreadCount(0));
+    {
+      lock_guard<mutex> lock(mutex_);
+      while (static_cast<int>(threads_.size()) < limit) {
+        threads_.emplace_back([this] { Work(); });
+      }
+      for (int h = 0; h < limit; h++) {
+        queue_.push_back(job);
+      }
+    }
+    if (limit == 1) {
+      wake_.notify_one();
+    } else {
+      wake_.notify_all();
+    }
+  }
+
+ private:
+  void Work() {
+    for (;;) {
+      shared_ptr<ParallelJob> job;
+      {
+        unique_lock<mutex> lock(mutex_);
+        wake_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (stop_) {
+          return;
+        }
+        job = move(queue_.front());
+        queue_.pop_front();
+      }
+      job->Help();
+    }
+  }
+
+  mutex mutex_;
+  condition_variable wake_;
+  deque<shared_ptr<ParallelJob>> queue_;
+  vector<thread> threads_;
+  bool stop_ = false;
+};
+
+/** Resolve a requested thread count
+ *
+ *  \param[in] num_threads  requested number of threads (if less than 1, use
+ *                          the number of hardware threads)
+ *
+ *  \return                 number of threads to use (at least 1)
+ */
+int ThreadCount(const int num_threads) {
+  if (num_threads > 0) {
+    return num_threads;
+  }
+  return max(1, static_cast<int>(thread::hardware_concurrency()));
+}
+
+/** Run body(begin, end) over the index range [0, count) on a pool of threads
+ *
+ *  \param[in] count        number of work items
+ *  \param[in] num_threads  number of threads (if less than 1, use the number
+ *                          of hardware threads)
+ *  \param[in] body         callable processing the indices [begin, end)
+ *  \param[in] chunk_size   number of indices claimed at a time
+ */
+void ParallelFor(const int count, const int num_threads,
+                 const function<void(int, int)> &body, const int chunk_size) {
+  if (count <= 0) {
+    return;
+  }
+  int chunk = max(1, chunk_size);
+  int num_chunks = (count + chunk - 1) / chunk;
+  int workers = min(ThreadCount(num_threads), num_chunks);
+
+  // Single worker, no reason to wake a thread
+  if (workers == 1) {
+    body(0, count);
+    return;
+  }
+
+  auto job = make_shared<ParallelJob>();
+  job->body = &body;
+  job->count = count;
+  job->chunk = chunk;
+  job->num_chunks = num_chunks;
+  ThreadPool::Instance().Submit(job, workers - 1);
+
+  // An exception from any participant is rethrown once the helpers still
+  // running body have finished with the caller's frame
+  job->Run();
+  job->Wait();
+  if (job->error) {
+    rethrow_exception(job->error);
+  }
+}
+} // namespace ipcv
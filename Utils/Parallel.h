@@ -0,0 +1,43 @@
+/** Interface file for distributing work over a pool of threads
+ *
+ *  \file ipcv/utils/Parallel.h
+ *  \author Andrea Avendano (aa6588@rit.edu)
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <functional>
+
+namespace ipcv {
+
+/** Resolve a requested thread count
+ *
+ *  \param[in] num_threads  requested number of threads (if less than 1, use
+ *                          the number of hardware threads)
+ *
+ *  \return                 number of threads to use (at least 1)
+ */
+int ThreadCount(const int num_threads);
+
+/** Run body(begin, end) over the index range [0, count) on a pool of threads
+ *
+ *  Workers repeatedly claim the next chunk of chunk_size indices until the
+ *  range is exhausted, so uneven work balances itself.  The calling thread
+ *  takes part as one of the workers.  The function returns once every index
+ *  has been processed.  The other workers are kept for the life of the
+ *  program, so repeated calls do not create threads; the pool never grows
+ *  beyond the number of hardware threads, however large num_threads is.  If
+ *  body throws on any thread, no further chunks are claimed and the first
+ *  exception is rethrown to the caller once every worker has stopped.
+ *
+ *  \param[in] count        number of work items
+ *  \param[in] num_threads  number of threads (if less than 1, use the number
+ *                          of hardware threads)
+ *  \param[in] body         callable processing the indices [begin, end)
+ *  \param[in] chunk_size   number of indices claimed at a time
+ */
+void ParallelFor(const int count, const int num_threads,
+                 const std::function<void(int, int)>& body,
+                 const int chunk_size = 1);
+}